@@ -14,7 +14,7 @@ def parse_args():
     # seed는 나중에 쓸 수 있게만 남겨두고, 현재 build_env는 내부에서 random_device 사용
     parser.add_argument( "--seed", type=int, default=None, help="(Optional) Random seed")
     parser.add_argument( "--roadmap", type=str, default="prm_random", 
-                        choices=["prm_random", "prm_halton", "prm_sobol", "visibility", "gvd", "rrt"], help="Roadmap algorithm")
+                        choices=["prm_random", "prm_halton", "prm_sobol", "prm_gaussian", "prm_bridge", "prm_medial", "prm_poisson", "visibility", "gvd", "rrt"], help="Roadmap algorithm")
     parser.add_argument( "--search_method", type=str, default="astar", 
                         choices=["bfs", "dfs", "gbfs", "astar", "wastar"], help="Path finding algorithm")
     
@@ -9,10 +9,19 @@ import os
 
 # ---------------------------- Utilities ----------------------------
 
+# world 범위 (env.txt 첫 줄에 "world <min> <max>" 가 있으면 load_env 가 바꿈)
+WORLD = (0.0, 20.0)
+
+
 def load_env(path):
+    global WORLD
     path = Path(path)
     with path.open() as f:
-        f.readline()  # skip seed line
+        header = f.readline().split()  # "# seed <value> [world <min> <max>]"
+        WORLD = (0.0, 20.0)
+        if "world" in header:
+            i = header.index("world")
+            WORLD = (float(header[i + 1]), float(header[i + 2]))
         m = int(f.readline().strip())
         obstacles = []
         for _ in range(m):
@@ -87,8 +96,8 @@ def _draw_scene(ax, obstacles, start, goal,
     ax.scatter([start[0]], [start[1]], s=60, marker="o", label="start")
     ax.scatter([goal[0]], [goal[1]], s=60, marker="*", label="goal")
 
-    ax.set_xlim(0, 20)
-    ax.set_ylim(0, 20)
+    ax.set_xlim(*WORLD)
+    ax.set_ylim(*WORLD)
     ax.set_aspect("equal", "box")
 
 
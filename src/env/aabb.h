@@ -0,0 +1,86 @@
+// /src/env/aabb.h
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "vec2.h"
+
+// axis-aligned bounding box
+struct AABB {
+    Vec2 min, max;
+
+    // 빈 box (아무 점이나 expand 하면 그 점이 된다)
+    AABB()
+        : min(std::numeric_limits<double>::infinity(),
+              std::numeric_limits<double>::infinity()),
+          max(-std::numeric_limits<double>::infinity(),
+              -std::numeric_limits<double>::infinity()) {}
+    AABB(const Vec2 &lo, const Vec2 &hi) : min(lo), max(hi) {}
+
+    bool empty() const { return min.x > max.x || min.y > max.y; }
+
+    void expand(const Vec2 &p) {
+        min.x = std::min(min.x, p.x);
+        min.y = std::min(min.y, p.y);
+        max.x = std::max(max.x, p.x);
+        max.y = std::max(max.y, p.y);
+    }
+
+    void expand(const AABB &b) {
+        min.x = std::min(min.x, b.min.x);
+        min.y = std::min(min.y, b.min.y);
+        max.x = std::max(max.x, b.max.x);
+        max.y = std::max(max.y, b.max.y);
+    }
+
+    AABB inflated(double m) const {
+        return AABB(Vec2(min.x - m, min.y - m), Vec2(max.x + m, max.y + m));
+    }
+
+    bool contains(const Vec2 &p) const {
+        return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+    }
+
+    // b 가 통째로 이 box 안에 있는지 (빈 box 는 어디에나 들어간다)
+    bool contains(const AABB &b) const {
+        return b.empty() || (b.min.x >= min.x && b.max.x <= max.x &&
+                             b.min.y >= min.y && b.max.y <= max.y);
+    }
+
+    bool overlaps(const AABB &b) const {
+        return min.x <= b.max.x && b.min.x <= max.x &&
+               min.y <= b.max.y && b.min.y <= max.y;
+    }
+
+    // 선분 a + t(b - a), t in [t0, t1] 을 box로 clipping (slab 방식)
+    // 겹치는 부분이 없으면 false
+    bool clipSegment(const Vec2 &a, const Vec2 &b, double &t0, double &t1) const {
+        t0 = 0.0;
+        t1 = 1.0;
+        const double d[2]  = {b.x - a.x, b.y - a.y};
+        const double o[2]  = {a.x, a.y};
+        const double lo[2] = {min.x, min.y};
+        const double hi[2] = {max.x, max.y};
+        for (int k = 0; k < 2; ++k) {
+            if (d[k] == 0.0) {
+                if (o[k] < lo[k] || o[k] > hi[k])
+                    return false;
+                continue;
+            }
+            double inv = 1.0 / d[k];
+            double ta = (lo[k] - o[k]) * inv;
+            double tb = (hi[k] - o[k]) * inv;
+            if (ta > tb) std::swap(ta, tb);
+            t0 = std::max(t0, ta);
+            t1 = std::min(t1, tb);
+            if (t0 > t1)
+                return false;
+        }
+        return true;
+    }
+
+    bool overlapsSegment(const Vec2 &a, const Vec2 &b) const {
+        double t0, t1;
+        return clipSegment(a, b, t0, t1);
+    }
+};
@@ -0,0 +1,38 @@
+// /src/env/batch.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "vec2.h"
+
+struct Segment {
+    Vec2 a, b;
+    Segment() = default;
+    Segment(const Vec2 &a_, const Vec2 &b_) : a(a_), b(b_) {}
+};
+
+// batch 충돌 검사 결과: bit i 가 1 이면 i 번째 항목이 free
+class FreeMask {
+public:
+    explicit FreeMask(std::size_t n = 0) : n_(n), words_((n + 63) / 64, 0) {}
+
+    std::size_t size() const { return n_; }
+
+    bool test(std::size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1u; }
+    void set(std::size_t i) { words_[i >> 6] |= std::uint64_t(1) << (i & 63); }
+
+    std::size_t count() const {
+        std::size_t c = 0;
+        for (std::uint64_t w : words_)
+            c += static_cast<std::size_t>(__builtin_popcountll(w));
+        return c;
+    }
+
+    // 64개 단위 word (word 하나는 한 thread 가 채우도록 나누면 안전)
+    std::vector<std::uint64_t> &words() { return words_; }
+    const std::vector<std::uint64_t> &words() const { return words_; }
+
+private:
+    std::size_t n_;
+    std::vector<std::uint64_t> words_;
+};
@@ -1,13 +1,157 @@
 // /src/env/build_env.cc
+#include "env_file.h"
 #include "environment.h"
+#include "parallel.h"
 #include "rng.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// "--key=value" 옵션들을 읽는다 (값이 없으면 "1")
+static std::map<std::string, std::string> parseOptions(int argc, char** argv, int first) {
+    std::map<std::string, std::string> opts;
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0)
+            throw std::runtime_error("Unexpected argument: " + arg);
+        std::size_t eq = arg.find('=');
+        if (eq == std::string::npos)
+            opts[arg.substr(2)] = "1";
+        else
+            opts[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+    }
+    return opts;
+}
+
+// 옵션이 하나라도 있으면 대규모 생성 (generateLarge)
+static LargeEnvParams largeParamsFromOptions(int M, std::map<std::string, std::string> &opts) {
+    LargeEnvParams params;
+    params.max_obstacles = M;
+    if (opts.count("world"))
+        params.world_max = params.world_min + std::stod(opts["world"]);
+    if (opts.count("density"))
+        params.density = std::stod(opts["density"]);
+    if (opts.count("size_min"))
+        params.size_min = std::stod(opts["size_min"]);
+    if (opts.count("size_max"))
+        params.size_max = std::stod(opts["size_max"]);
+    if (opts.count("size_dist"))
+        params.size_dist = sizeDistributionFromString(opts["size_dist"]);
+    return params;
+}
+
+// seed 하나로 환경을 만든다 (RNG 는 thread 별이라 여러 thread 에서 동시에 불러도 된다)
+static void generateEnvironment(Environment &env, int M, unsigned int seed, bool large,
+                                const LargeEnvParams &params) {
+    RNG::seed(seed);
+    if (large)
+        env.generateLarge(params);
+    else
+        env.generateRandom(M);
+}
+
+// "<first>:<last>" (양 끝 포함)
+static void parseSeedRange(const std::string &text, unsigned int &first, unsigned int &last) {
+    std::size_t colon = text.find(':');
+    if (colon == std::string::npos)
+        throw std::runtime_error("--seeds expects <first>:<last>, got: " + text);
+    first = static_cast<unsigned int>(std::stoul(text.substr(0, colon)));
+    last  = static_cast<unsigned int>(std::stoul(text.substr(colon + 1)));
+    if (last < first)
+        throw std::runtime_error("--seeds range is empty: " + text);
+}
+
+// 여러 seed 의 env.txt 를 하나의 pack 파일로 (형식은 README 참고)
+//   # envpack 1 count <N> index <offset>     <- 고정 폭 header, 마지막에 채운다
+//   <env.txt 내용> ...                        <- seed 순서대로
+//   <seed> <offset> <size>                    <- index (N 줄, offset 은 파일 처음부터 byte 단위)
+static int writeEnvPack(const std::string &path, int M, unsigned int first, unsigned int last,
+                        bool large, const LargeEnvParams &params, int threads) {
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) {
+        std::cerr << "[build_env] Cannot open pack file for writing: " << path << "\n";
+        return 1;
+    }
+
+    auto header = [](std::uint64_t count, std::uint64_t index_offset) {
+        char buf[80];
+        std::snprintf(buf, sizeof(buf), "# envpack 1 count %020llu index %020llu\n",
+                      static_cast<unsigned long long>(count),
+                      static_cast<unsigned long long>(index_offset));
+        return std::string(buf);
+    };
+    ofs << header(0, 0);
+
+    struct Entry {
+        unsigned int seed;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+    const std::uint64_t count = static_cast<std::uint64_t>(last) - first + 1;
+    std::vector<Entry> index;
+    index.reserve(count);
+
+    // block 단위로 만들고 순서대로 쓴다 (메모리는 block 크기만큼만)
+    const int n_threads = resolveThreadCount(threads);
+    const std::uint64_t block = static_cast<std::uint64_t>(n_threads) * 64;
+    std::vector<std::string> texts;
+    for (std::uint64_t b0 = 0; b0 < count; b0 += block) {
+        const int n = static_cast<int>(std::min(block, count - b0));
+        texts.assign(n, std::string());
+        parallelFor(0, n, [&](int i) {
+            const unsigned int seed = static_cast<unsigned int>(first + b0 + i);
+            Environment env;
+            generateEnvironment(env, M, seed, large, params);
+            std::ostringstream os;
+            writeEnvironmentText(os, env, seed, large);
+            texts[i] = os.str();
+        }, n_threads, /*chunk=*/1);
+
+        for (int i = 0; i < n; ++i) {
+            index.push_back({static_cast<unsigned int>(first + b0 + i),
+                             static_cast<std::uint64_t>(ofs.tellp()), texts[i].size()});
+            ofs.write(texts[i].data(), static_cast<std::streamsize>(texts[i].size()));
+        }
+    }
+
+    const std::uint64_t index_offset = static_cast<std::uint64_t>(ofs.tellp());
+    for (const auto &e : index)
+        ofs << e.seed << " " << e.offset << " " << e.size << "\n";
+    ofs.seekp(0);
+    ofs << header(count, index_offset);
+
+    if (!ofs) {
+        std::cerr << "[build_env] Failed while writing pack file: " << path << "\n";
+        return 1;
+    }
+    std::cout << "[build_env] Wrote " << count << " environments (seeds " << first << ".." << last
+              << ") to " << path << " using " << n_threads << " threads\n";
+    return 0;
+}
 
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <num_obstacles> [seed]\n";
+        std::cerr << "Usage: " << argv[0] << " <num_obstacles> [seed] [options]\n";
+        std::cerr << "options (any of them switches to large-scale generation, no 20-obstacle clamp):\n";
+        std::cerr << "  --large                   large-scale generation with default parameters\n";
+        std::cerr << "  --world=<size>            world is [0, size]^2 (default: 200)\n";
+        std::cerr << "  --density=<fraction>      stop when obstacle area / world area reaches this (default: 0.3)\n";
+        std::cerr << "  --size_min=<r>            minimum obstacle radius (default: 0.7)\n";
+        std::cerr << "  --size_max=<r>            maximum obstacle radius (default: 2.5)\n";
+        std::cerr << "  --size_dist=uniform|loguniform   radius distribution (default: uniform)\n";
+        std::cerr << "  --format=text|binary      env.txt (default) or env.bin (exact doubles, mmap-able)\n";
+        std::cerr << "batch options (one pack file for a seed range instead of env.txt):\n";
+        std::cerr << "  --seeds=<first>:<last>    generate every seed in the range (inclusive)\n";
+        std::cerr << "  --out=<file>              pack file (default: envs.pack)\n";
+        std::cerr << "  --threads=<n>             worker threads (default: all cores)\n";
         return 1;
     }
 
@@ -15,8 +159,56 @@ int main(int argc, char** argv) {
     if (M < 0) M = 0;
 
     unsigned int seed;
+    const bool has_seed = (argc >= 3 && std::string(argv[2]).rfind("--", 0) != 0);
+
+    std::map<std::string, std::string> opts;
+    std::map<std::string, std::string> batch;
+    LargeEnvParams params;
+    std::string format = "text";
+    try {
+        opts = parseOptions(argc, argv, has_seed ? 3 : 2);
+        // 출력 / batch 옵션은 생성 방식과 무관하므로 먼저 떼어낸다
+        if (opts.count("format")) {
+            format = opts["format"];
+            opts.erase("format");
+            if (format != "text" && format != "binary")
+                throw std::runtime_error("Unknown format: " + format);
+        }
+        for (const char *key : {"seeds", "out", "threads"}) {
+            if (opts.count(key)) {
+                batch[key] = opts[key];
+                opts.erase(key);
+            }
+        }
+        params = largeParamsFromOptions(M, opts);
+    } catch (const std::exception &e) {
+        std::cerr << "[build_env] " << e.what() << "\n";
+        return 1;
+    }
+    const bool large = !opts.empty();
+
+    if (!batch.empty()) {
+        if (has_seed || !batch.count("seeds")) {
+            std::cerr << "[build_env] Batch mode needs --seeds=<first>:<last> instead of [seed]\n";
+            return 1;
+        }
+        if (format != "text") {
+            std::cerr << "[build_env] Batch mode only writes the text format\n";
+            return 1;
+        }
+        try {
+            unsigned int first, last;
+            parseSeedRange(batch["seeds"], first, last);
+            const std::string out = batch.count("out") ? batch["out"] : "envs.pack";
+            const int threads = batch.count("threads") ? std::stoi(batch["threads"]) : 0;
+            return writeEnvPack(out, M, first, last, large, params, threads);
+        } catch (const std::exception &e) {
+            std::cerr << "[build_env] " << e.what() << "\n";
+            return 1;
+        }
+    }
 
-    if (argc >= 3) {
+    if (has_seed) {
         // Python이 seed를 줬을 때
         seed = static_cast<unsigned int>(std::stoul(argv[2]));
         std::cout << "[build_env] Using provided seed = " << seed << "\n";
@@ -27,23 +219,30 @@ int main(int argc, char** argv) {
         std::cout << "[build_env] Generated random seed = " << seed << "\n";
     }
 
-    RNG::seed(seed);
-
     Environment env;
-    env.generateRandom(M);
-
-    std::ofstream ofs("env.txt");
-    ofs << "# seed " << seed << "\n";
-    ofs << env.obstacles.size() << "\n";
+    try {
+        generateEnvironment(env, M, seed, large, params);
+    } catch (const std::exception &e) {
+        std::cerr << "[build_env] " << e.what() << "\n";
+        return 1;
+    }
+    if (large) {
+        std::cout << "[build_env] Generated " << env.obstacles.size() << " obstacles in ["
+                  << env.world_min << ", " << env.world_max << "]^2\n";
+    }
 
-    for (const auto& obs : env.obstacles) {
-        ofs << obs.pts.size() << "\n";
-        for (const auto& p : obs.pts)
-            ofs << p.x << " " << p.y << "\n";
+    if (format == "binary") {
+        try {
+            saveEnvironmentBinary("env.bin", env, seed);
+        } catch (const std::exception &e) {
+            std::cerr << "[build_env] " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
     }
 
-    ofs << env.start.x << " " << env.start.y << "\n";
-    ofs << env.goal.x  << " " << env.goal.y << "\n";
+    std::ofstream ofs("env.txt");
+    writeEnvironmentText(ofs, env, seed, large);
 
     return 0;
 }
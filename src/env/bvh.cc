@@ -0,0 +1,232 @@
+// /src/env/bvh.cc
+#include "bvh.h"
+#include <algorithm>
+
+namespace {
+    double perimeter(const AABB &b) {
+        return 2.0 * ((b.max.x - b.min.x) + (b.max.y - b.min.y));
+    }
+
+    AABB unite(const AABB &a, const AABB &b) {
+        AABB r = a;
+        r.expand(b);
+        return r;
+    }
+}
+
+void BVH::clear() {
+    nodes_.clear();
+    free_nodes_.clear();
+    leaf_of_prim_.clear();
+    root_ = -1;
+}
+
+void BVH::build(const std::vector<AABB> &boxes) {
+    clear();
+    const int n = static_cast<int>(boxes.size());
+    if (n == 0)
+        return;
+
+    std::vector<int> prims(n);
+    std::vector<Vec2> centers(n);
+    for (int i = 0; i < n; ++i) {
+        prims[i] = i;
+        centers[i] = Vec2(0.5 * (boxes[i].min.x + boxes[i].max.x),
+                          0.5 * (boxes[i].min.y + boxes[i].max.y));
+    }
+    nodes_.reserve(2 * n - 1);
+    leaf_of_prim_.assign(n, -1);
+    root_ = buildRange(prims, centers, boxes, 0, n, -1);
+}
+
+void BVH::assign(std::vector<Node> nodes, int root) {
+    clear();
+    nodes_ = std::move(nodes);
+    root_ = root;
+
+    std::vector<char> reachable(nodes_.size(), 0);
+    std::vector<int> stack;
+    if (root_ >= 0)
+        stack.push_back(root_);
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+        reachable[id] = 1;
+        const Node &n = nodes_[id];
+        if (n.leaf()) {
+            if (n.prim >= static_cast<int>(leaf_of_prim_.size()))
+                leaf_of_prim_.resize(n.prim + 1, -1);
+            leaf_of_prim_[n.prim] = id;
+            continue;
+        }
+        stack.push_back(n.left);
+        stack.push_back(n.right);
+    }
+    for (int id = 0; id < static_cast<int>(nodes_.size()); ++id) {
+        if (!reachable[id])
+            free_nodes_.push_back(id);
+    }
+}
+
+int BVH::buildRange(std::vector<int> &prims, std::vector<Vec2> &centers,
+                    const std::vector<AABB> &boxes, int begin, int end, int parent) {
+    int id = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    nodes_[id].parent = parent;
+
+    if (end - begin == 1) {
+        nodes_[id].prim = prims[begin];
+        nodes_[id].box = boxes[prims[begin]];
+        leaf_of_prim_[prims[begin]] = id;
+        return id;
+    }
+
+    // 중심점 분포가 가장 긴 축으로 median split
+    AABB cb;
+    for (int i = begin; i < end; ++i)
+        cb.expand(centers[prims[i]]);
+    bool split_x = (cb.max.x - cb.min.x) >= (cb.max.y - cb.min.y);
+
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(prims.begin() + begin, prims.begin() + mid, prims.begin() + end,
+                     [&](int a, int b) {
+                         return split_x ? centers[a].x < centers[b].x
+                                        : centers[a].y < centers[b].y;
+                     });
+
+    int left  = buildRange(prims, centers, boxes, begin, mid, id);
+    int right = buildRange(prims, centers, boxes, mid, end, id);
+
+    // nodes_ 는 reserve 해두었으므로 재할당 없음
+    Node &node = nodes_[id];
+    node.left = left;
+    node.right = right;
+    node.box = nodes_[left].box;
+    node.box.expand(nodes_[right].box);
+    return id;
+}
+
+int BVH::allocNode() {
+    if (!free_nodes_.empty()) {
+        int id = free_nodes_.back();
+        free_nodes_.pop_back();
+        nodes_[id] = Node();
+        return id;
+    }
+    nodes_.emplace_back();
+    return static_cast<int>(nodes_.size()) - 1;
+}
+
+void BVH::freeNode(int id) {
+    nodes_[id] = Node();
+    free_nodes_.push_back(id);
+}
+
+void BVH::refitFrom(int id) {
+    while (id >= 0) {
+        Node &n = nodes_[id];
+        n.box = unite(nodes_[n.left].box, nodes_[n.right].box);
+        id = n.parent;
+    }
+}
+
+void BVH::insert(int prim, const AABB &box) {
+    int leaf = allocNode();
+    nodes_[leaf].box = box;
+    nodes_[leaf].prim = prim;
+    if (prim >= static_cast<int>(leaf_of_prim_.size()))
+        leaf_of_prim_.resize(prim + 1, -1);
+    leaf_of_prim_[prim] = leaf;
+
+    if (root_ < 0) {
+        root_ = leaf;
+        return;
+    }
+
+    // sibling 선택: 여기서 붙였을 때의 비용과 자식으로 내려갔을 때의 하한을 비교
+    int idx = root_;
+    while (!nodes_[idx].leaf()) {
+        const Node &n = nodes_[idx];
+        double combined = perimeter(unite(n.box, box));
+        // Box2D dynamic tree 와 같은 비용 (새 parent 생성 + 조상들이 커지는 양)
+        double cost = 2.0 * combined;
+        double inherit = 2.0 * (combined - perimeter(n.box));
+
+        auto descendCost = [&](int child) {
+            const AABB merged = unite(nodes_[child].box, box);
+            double c = perimeter(merged);
+            if (!nodes_[child].leaf())
+                c -= perimeter(nodes_[child].box);
+            return c + inherit;
+        };
+        double cost_left = descendCost(n.left);
+        double cost_right = descendCost(n.right);
+        if (cost < cost_left && cost < cost_right)
+            break;
+        idx = (cost_left < cost_right) ? n.left : n.right;
+    }
+
+    int sibling = idx;
+    int old_parent = nodes_[sibling].parent;
+    int new_parent = allocNode();
+    nodes_[new_parent].parent = old_parent;
+    nodes_[new_parent].left = sibling;
+    nodes_[new_parent].right = leaf;
+    nodes_[new_parent].box = unite(nodes_[sibling].box, box);
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+
+    if (old_parent < 0) {
+        root_ = new_parent;
+    } else {
+        if (nodes_[old_parent].left == sibling)
+            nodes_[old_parent].left = new_parent;
+        else
+            nodes_[old_parent].right = new_parent;
+        refitFrom(old_parent);
+    }
+}
+
+void BVH::remove(int prim) {
+    if (prim < 0 || prim >= static_cast<int>(leaf_of_prim_.size()) || leaf_of_prim_[prim] < 0)
+        return;
+    int leaf = leaf_of_prim_[prim];
+    leaf_of_prim_[prim] = -1;
+
+    if (leaf == root_) {
+        freeNode(leaf);
+        root_ = -1;
+        return;
+    }
+
+    int parent = nodes_[leaf].parent;
+    int grand = nodes_[parent].parent;
+    int sibling = (nodes_[parent].left == leaf) ? nodes_[parent].right : nodes_[parent].left;
+
+    if (grand < 0) {
+        root_ = sibling;
+        nodes_[sibling].parent = -1;
+    } else {
+        if (nodes_[grand].left == parent)
+            nodes_[grand].left = sibling;
+        else
+            nodes_[grand].right = sibling;
+        nodes_[sibling].parent = grand;
+        refitFrom(grand);
+    }
+    freeNode(parent);
+    freeNode(leaf);
+}
+
+void BVH::relabel(int old_prim, int new_prim) {
+    if (old_prim == new_prim || old_prim >= static_cast<int>(leaf_of_prim_.size()))
+        return;
+    int leaf = leaf_of_prim_[old_prim];
+    leaf_of_prim_[old_prim] = -1;
+    if (leaf < 0)
+        return;
+    if (new_prim >= static_cast<int>(leaf_of_prim_.size()))
+        leaf_of_prim_.resize(new_prim + 1, -1);
+    leaf_of_prim_[new_prim] = leaf;
+    nodes_[leaf].prim = new_prim;
+}
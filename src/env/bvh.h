@@ -0,0 +1,171 @@
+// /src/env/bvh.h
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "aabb.h"
+
+// AABB bounding-volume hierarchy (leaf 하나에 primitive 하나)
+// primitive 는 0..N-1 정수 id 로만 다루고, 실제 검사는 query 의 callback 이 한다.
+class BVH {
+public:
+    struct Node {
+        AABB box;
+        int parent = -1;
+        int left   = -1;   // leaf 이면 -1
+        int right  = -1;
+        int prim   = -1;   // leaf 일 때 primitive id
+        bool leaf() const { return left < 0; }
+    };
+
+    BVH() = default;
+
+    // boxes[i] 가 primitive i 의 bounding box (top-down median split)
+    void build(const std::vector<AABB> &boxes);
+    void clear();
+
+    // 미리 만들어 둔 node 배열을 그대로 쓴다 (파일에서 읽은 index 등)
+    // root 에서 닿지 않는 node 는 빈 node 로 재사용한다
+    void assign(std::vector<Node> nodes, int root);
+
+    // 점진적 갱신 (전체 rebuild 없이 leaf 하나를 넣고/빼고 조상 box 만 refit)
+    // insert 는 perimeter 증가량이 가장 작은 sibling 을 찾아 붙인다
+    void insert(int prim, const AABB &box);
+    void remove(int prim);
+    // primitive id 변경 (swap-and-pop 으로 index 가 바뀐 경우)
+    void relabel(int old_prim, int new_prim);
+
+    bool empty() const { return root_ < 0; }
+    const std::vector<Node> &nodes() const { return nodes_; }
+    int root() const { return root_; }
+
+    // box 가 점 p 를 포함하는 primitive 마다 visit(prim) 호출
+    // visit 이 true 를 반환하면 즉시 중단하고 true 반환
+    template <class Visit>
+    bool queryPoint(const Vec2 &p, Visit &&visit) const;
+
+    // box 가 선분 (a,b)와 겹치는 primitive 마다 visit(prim) 호출
+    template <class Visit>
+    bool querySegment(const Vec2 &a, const Vec2 &b, Visit &&visit) const;
+
+    // 최대 64개 query 를 한 번의 traversal 로 같이 내려간다 (lanes 의 bit 하나가 query 하나)
+    // - overlaps(box, lane) 이 true 인 lane 만 그 node 의 자식으로 내려간다
+    // - leaf 에서 visit(prim, lanes) 를 부르고, 반환한 lane 들은 끝난 것으로 보고 더 보지 않는다
+    // 반환값은 끝난 lane 들 (모든 lane 이 끝나면 바로 돌아온다)
+    template <class Overlaps, class Visit>
+    std::uint64_t queryPacket(std::uint64_t lanes, Overlaps &&overlaps, Visit &&visit) const;
+
+private:
+    // 고정 크기 배열을 먼저 쓰고 넘치면 heap 으로 (query 마다 할당하지 않도록)
+    template <class T>
+    class TraversalStack {
+    public:
+        void push(const T &i) {
+            if (top_ < kLocal) local_[top_++] = i;
+            else spill_.push_back(i);
+        }
+        T pop() {
+            if (!spill_.empty()) {
+                T i = spill_.back();
+                spill_.pop_back();
+                return i;
+            }
+            return local_[--top_];
+        }
+        bool empty() const { return top_ == 0 && spill_.empty(); }
+    private:
+        static constexpr int kLocal = 64;
+        T local_[kLocal];
+        int top_ = 0;
+        std::vector<T> spill_;
+    };
+
+    struct PacketEntry {
+        int node;
+        std::uint64_t lanes;  // 부모 box 와 겹친 lane
+    };
+
+    int buildRange(std::vector<int> &prims, std::vector<Vec2> &centers,
+                   const std::vector<AABB> &boxes, int begin, int end, int parent);
+    int allocNode();
+    void freeNode(int id);
+    void refitFrom(int id);
+
+    std::vector<Node> nodes_;
+    std::vector<int>  free_nodes_;    // remove 로 비워진 node (재사용)
+    std::vector<int>  leaf_of_prim_;  // primitive -> leaf node (-1 이면 없음)
+    int root_ = -1;
+};
+
+// ---------- query 구현 (inline) ----------
+
+template <class Visit>
+bool BVH::queryPoint(const Vec2 &p, Visit &&visit) const {
+    if (root_ < 0)
+        return false;
+    TraversalStack<int> stack;
+    stack.push(root_);
+    while (!stack.empty()) {
+        const Node &n = nodes_[stack.pop()];
+        if (!n.box.contains(p))
+            continue;
+        if (n.leaf()) {
+            if (visit(n.prim))
+                return true;
+            continue;
+        }
+        stack.push(n.right);
+        stack.push(n.left);
+    }
+    return false;
+}
+
+template <class Visit>
+bool BVH::querySegment(const Vec2 &a, const Vec2 &b, Visit &&visit) const {
+    if (root_ < 0)
+        return false;
+    TraversalStack<int> stack;
+    stack.push(root_);
+    while (!stack.empty()) {
+        const Node &n = nodes_[stack.pop()];
+        if (!n.box.overlapsSegment(a, b))
+            continue;
+        if (n.leaf()) {
+            if (visit(n.prim))
+                return true;
+            continue;
+        }
+        stack.push(n.right);
+        stack.push(n.left);
+    }
+    return false;
+}
+
+template <class Overlaps, class Visit>
+std::uint64_t BVH::queryPacket(std::uint64_t lanes, Overlaps &&overlaps, Visit &&visit) const {
+    if (root_ < 0 || lanes == 0)
+        return 0;
+    TraversalStack<PacketEntry> stack;
+    stack.push({root_, lanes});
+    std::uint64_t done = 0;
+    while (!stack.empty()) {
+        const PacketEntry e = stack.pop();
+        const Node &n = nodes_[e.node];
+        std::uint64_t active = 0;
+        for (std::uint64_t r = e.lanes & ~done; r; r &= r - 1) {
+            const int l = __builtin_ctzll(r);
+            if (overlaps(n.box, l))
+                active |= std::uint64_t(1) << l;
+        }
+        if (active == 0)
+            continue;
+        if (n.leaf()) {
+            done |= visit(n.prim, active) & active;
+            if (done == lanes)
+                return done;
+            continue;
+        }
+        stack.push({n.right, active});
+        stack.push({n.left, active});
+    }
+    return done;
+}
@@ -0,0 +1,218 @@
+// /src/env/clearance_field.cc
+#include "clearance_field.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "parallel.h"
+
+namespace {
+    constexpr double kMargin = 1e-6;
+    constexpr int kMaxCellsPerAxis = 4096;
+    constexpr double kSqrt2 = 1.41421356237309504880;
+    // seed 가 아닌 cell 의 초기값 (FH 계산에서 inf - inf 를 피하려고 유한값 사용)
+    constexpr double kFar = 1e20;
+
+    // Felzenszwalb-Huttenlocher 1D squared distance transform
+    // d[i] = min_q ((i - q)^2 + f[q]),  stride 간격으로 저장된 n 개 값을 in-place 로
+    void edt1d(double *data, int n, int stride,
+               std::vector<double> &f, std::vector<double> &z, std::vector<int> &v) {
+        f.resize(n);
+        z.resize(n + 1);
+        v.resize(n);
+        for (int i = 0; i < n; ++i)
+            f[i] = data[i * stride];
+
+        int k = 0;
+        v[0] = 0;
+        z[0] = -std::numeric_limits<double>::infinity();
+        z[1] =  std::numeric_limits<double>::infinity();
+        for (int q = 1; q < n; ++q) {
+            // z[0] = -inf 이므로 k 는 0 아래로 내려가지 않는다
+            double s = ((f[q] + double(q) * q) - (f[v[k]] + double(v[k]) * v[k])) /
+                       (2.0 * (q - v[k]));
+            while (s <= z[k]) {
+                --k;
+                s = ((f[q] + double(q) * q) - (f[v[k]] + double(v[k]) * v[k])) /
+                    (2.0 * (q - v[k]));
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = std::numeric_limits<double>::infinity();
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q) {
+            while (z[k + 1] < q)
+                ++k;
+            double d = q - v[k];
+            data[q * stride] = d * d + f[v[k]];
+        }
+    }
+}
+
+double pointSegmentDistance(const Vec2 &p, const Segment &s) {
+    double vx = s.b.x - s.a.x, vy = s.b.y - s.a.y;
+    double wx = p.x - s.a.x,   wy = p.y - s.a.y;
+    double len2 = vx * vx + vy * vy;
+    double t = (len2 > 0.0) ? (wx * vx + wy * vy) / len2 : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    double dx = wx - t * vx, dy = wy - t * vy;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+void ClearanceField::clear() {
+    bounds_ = AABB();
+    cell_ = 0.0;
+    nx_ = ny_ = 0;
+    edges_.clear();
+    cell_start_.clear();
+    cell_items_.clear();
+    dist_.clear();
+}
+
+int ClearanceField::clampX(double x) const {
+    int i = static_cast<int>(std::floor((x - bounds_.min.x) / cell_));
+    return std::max(0, std::min(i, nx_ - 1));
+}
+
+int ClearanceField::clampY(double y) const {
+    int i = static_cast<int>(std::floor((y - bounds_.min.y) / cell_));
+    return std::max(0, std::min(i, ny_ - 1));
+}
+
+void ClearanceField::build(const std::vector<Obstacle> &obstacles, const AABB &world,
+                           double cell_size, int threads) {
+    clear();
+    if (cell_size <= 0.0)
+        return;
+
+    bounds_ = world;
+    for (int oi = 0; oi < static_cast<int>(obstacles.size()); ++oi) {
+        const Obstacle &obs = obstacles[oi];
+        int n = static_cast<int>(obs.pts.size());
+        for (int i = 0; i < n; ++i)
+            edges_.push_back({Segment(obs.pts[i], obs.pts[(i + 1) % n]), oi, i});
+        bounds_.expand(obs.bbox);
+    }
+    if (bounds_.empty())
+        return;
+    bounds_ = bounds_.inflated(kMargin);
+
+    double w = bounds_.max.x - bounds_.min.x;
+    double h = bounds_.max.y - bounds_.min.y;
+    cell_ = std::max({cell_size, w / kMaxCellsPerAxis, h / kMaxCellsPerAxis});
+    nx_ = std::max(1, static_cast<int>(std::ceil(w / cell_)));
+    ny_ = std::max(1, static_cast<int>(std::ceil(h / cell_)));
+    const int num_cells = nx_ * ny_;
+
+    // 1) edge 를 cell 에 bucket (CSR). 두 번 돌면서 개수 -> 채우기
+    auto forEachCell = [&](const Segment &s, auto &&fn) {
+        AABB eb;
+        eb.expand(s.a);
+        eb.expand(s.b);
+        eb = eb.inflated(kMargin);
+        int ix0 = clampX(eb.min.x), ix1 = clampX(eb.max.x);
+        int iy0 = clampY(eb.min.y), iy1 = clampY(eb.max.y);
+        for (int iy = iy0; iy <= iy1; ++iy) {
+            for (int ix = ix0; ix <= ix1; ++ix) {
+                AABB cb(Vec2(bounds_.min.x + ix * cell_, bounds_.min.y + iy * cell_),
+                        Vec2(bounds_.min.x + (ix + 1) * cell_, bounds_.min.y + (iy + 1) * cell_));
+                if (cb.inflated(kMargin).overlapsSegment(s.a, s.b))
+                    fn(cellIndex(ix, iy));
+            }
+        }
+    };
+
+    cell_start_.assign(num_cells + 1, 0);
+    for (const Edge &e : edges_)
+        forEachCell(e.seg, [&](int c) { ++cell_start_[c + 1]; });
+    for (int c = 0; c < num_cells; ++c)
+        cell_start_[c + 1] += cell_start_[c];
+    cell_items_.resize(cell_start_[num_cells]);
+    std::vector<int> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (int ei = 0; ei < static_cast<int>(edges_.size()); ++ei)
+        forEachCell(edges_[ei].seg, [&](int c) { cell_items_[fill[c]++] = ei; });
+
+    // 2) seed cell 로부터의 squared EDT (cell 단위): column 들 -> row 들
+    dist_.assign(num_cells, kFar);
+    for (int c = 0; c < num_cells; ++c) {
+        if (cell_start_[c + 1] > cell_start_[c])
+            dist_[c] = 0.0;
+    }
+
+    parallelFor(0, nx_, [&](int ix) {
+        std::vector<double> f, z;
+        std::vector<int> v;
+        edt1d(&dist_[ix], ny_, nx_, f, z, v);
+    }, threads);
+    parallelFor(0, ny_, [&](int iy) {
+        std::vector<double> f, z;
+        std::vector<int> v;
+        edt1d(&dist_[iy * nx_], nx_, 1, f, z, v);
+    }, threads);
+
+    for (double &d : dist_)
+        d = std::sqrt(d) * cell_;
+}
+
+double ClearanceField::bruteForce(const Vec2 &p) const {
+    double best = std::numeric_limits<double>::infinity();
+    for (const Edge &e : edges_)
+        best = std::min(best, pointSegmentDistance(p, e.seg));
+    return best;
+}
+
+double ClearanceField::lowerBound(const Vec2 &p) const {
+    if (!built())
+        return 0.0;
+    if (edges_.empty())
+        return std::numeric_limits<double>::infinity();
+    if (!bounds_.contains(p))
+        return bruteForce(p);
+
+    // p 와 cell 중심, edge 와 seed cell 중심 사이가 각각 최대 cell 반대각선
+    double d = dist_[cellIndex(clampX(p.x), clampY(p.y))] - kSqrt2 * cell_ - kMargin;
+    return std::max(0.0, d);
+}
+
+double ClearanceField::clearance(const Vec2 &p) const {
+    if (!built() || edges_.empty() || !bounds_.contains(p))
+        return bruteForce(p);
+
+    const int cx = clampX(p.x);
+    const int cy = clampY(p.y);
+    const double lower = lowerBound(p);
+
+    // Chebyshev ring r 의 cell 은 p 로부터 (r-1)h 이상, (r+1)sqrt(2)h 이하 거리
+    // -> lower 보다 확실히 가까운 ring 은 건너뛰고, best 보다 먼 ring 에서 멈춘다
+    int r = std::max(0, static_cast<int>(std::ceil(lower / (kSqrt2 * cell_))) - 1);
+    const int r_max = std::max(nx_, ny_);
+    double best = std::numeric_limits<double>::infinity();
+
+    auto scanCell = [&](int ix, int iy) {
+        if (ix < 0 || ix >= nx_ || iy < 0 || iy >= ny_)
+            return;
+        int c = cellIndex(ix, iy);
+        for (int k = cell_start_[c]; k < cell_start_[c + 1]; ++k)
+            best = std::min(best, pointSegmentDistance(p, edges_[cell_items_[k]].seg));
+    };
+
+    for (; r <= r_max; ++r) {
+        if ((r - 1) * cell_ > best)
+            break;
+        if (r == 0) {
+            scanCell(cx, cy);
+            continue;
+        }
+        for (int dx = -r; dx <= r; ++dx) {
+            scanCell(cx + dx, cy - r);
+            scanCell(cx + dx, cy + r);
+        }
+        for (int dy = -r + 1; dy <= r - 1; ++dy) {
+            scanCell(cx - r, cy + dy);
+            scanCell(cx + r, cy + dy);
+        }
+    }
+    return best;
+}
@@ -0,0 +1,88 @@
+// /src/env/clearance_field.h
+#pragma once
+#include <vector>
+#include "aabb.h"
+#include "batch.h"
+#include "obstacle.h"
+
+// 점 p 와 선분 s 사이의 거리
+double pointSegmentDistance(const Vec2 &p, const Segment &s);
+
+// 가장 가까운 obstacle edge 까지의 거리 (clearance) 를 위한 precomputed field
+// - edge 가 지나가는 cell 을 seed 로 두고 exact Euclidean distance transform
+//   (Felzenszwalb-Huttenlocher, column/row 병렬) 을 계산
+// - lowerBound(p) 는 O(1), clearance(p) 는 lower/upper bound 사이의 cell 만 보고 exact 하게
+// 거리는 점이 obstacle 안/밖인지와 상관없이 edge 까지의 unsigned 거리이다.
+class ClearanceField {
+public:
+    struct Edge {
+        Segment seg;
+        int obs;   // obstacle index
+        int edge;  // obstacle 안에서의 edge index
+    };
+
+    ClearanceField() = default;
+
+    // world 와 obstacle 을 모두 덮는 영역에 cell_size 간격 grid 를 만든다
+    void build(const std::vector<Obstacle> &obstacles, const AABB &world,
+               double cell_size, int threads = 0);
+    void clear();
+
+    bool built() const { return nx_ > 0; }
+
+    // p 에서 어떤 edge 까지의 거리도 이 값 이상 (O(1))
+    double lowerBound(const Vec2 &p) const;
+
+    // p 에서 가장 가까운 edge 까지의 exact 거리 (edge 가 없으면 +inf)
+    double clearance(const Vec2 &p) const;
+
+    // center 를 중심으로 한 반지름 r 원과 겹칠 수 있는 edge 들에 대해 visit(const Edge &) 호출
+    // visit 이 true 를 반환하면 중단하고 true 반환 (같은 edge 가 여러 번 올 수 있음)
+    template <class Visit>
+    bool forEachEdgeNear(const Vec2 &center, double r, Visit &&visit) const;
+
+    double cellSize() const { return cell_; }
+    const AABB &bounds() const { return bounds_; }
+
+    // cell 중심에서 가장 가까운 seed cell 중심까지의 거리
+    double cellDistance(int ix, int iy) const { return dist_[cellIndex(ix, iy)]; }
+    int width() const { return nx_; }
+    int height() const { return ny_; }
+
+private:
+    int cellIndex(int ix, int iy) const { return iy * nx_ + ix; }
+    int clampX(double x) const;
+    int clampY(double y) const;
+    double bruteForce(const Vec2 &p) const;
+
+    AABB   bounds_;
+    double cell_ = 0.0;
+    int    nx_ = 0;
+    int    ny_ = 0;
+
+    std::vector<Edge>    edges_;       // 모든 obstacle edge
+    std::vector<int>     cell_start_;  // CSR: cell i 의 edge 는 cell_items_[cell_start_[i] .. cell_start_[i+1])
+    std::vector<int>     cell_items_;
+    std::vector<double>  dist_;        // cell 별 EDT 거리 (world 단위)
+};
+
+template <class Visit>
+bool ClearanceField::forEachEdgeNear(const Vec2 &center, double r, Visit &&visit) const {
+    if (!built())
+        return false;
+    AABB q(Vec2(center.x - r, center.y - r), Vec2(center.x + r, center.y + r));
+    if (!q.overlaps(bounds_))
+        return false;
+    int ix0 = clampX(q.min.x), ix1 = clampX(q.max.x);
+    int iy0 = clampY(q.min.y), iy1 = clampY(q.max.y);
+    for (int iy = iy0; iy <= iy1; ++iy) {
+        for (int ix = ix0; ix <= ix1; ++ix) {
+            int c = cellIndex(ix, iy);
+            for (int k = cell_start_[c]; k < cell_start_[c + 1]; ++k) {
+                if (visit(edges_[cell_items_[k]]))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
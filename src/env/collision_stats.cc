@@ -0,0 +1,142 @@
+// /src/env/collision_stats.cc
+#include "collision_stats.h"
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    // 시간을 잰 호출마다 들어간 clock 읽기 비용 (연속한 now() 두 번의 평균 간격)
+    double clockOverheadNs() {
+        static const double overhead = [] {
+            using clock = std::chrono::steady_clock;
+            constexpr int kReps = 4096;
+            clock::duration total{};
+            for (int i = 0; i < kReps; ++i) {
+                auto t0 = clock::now();
+                auto t1 = clock::now();
+                total += t1 - t0;
+            }
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(total).count()) / kReps;
+        }();
+        return overhead;
+    }
+}
+
+double CollisionCounters::seconds() const {
+    if (timed_calls == 0)
+        return 0.0;
+    const double ns = std::max(0.0, static_cast<double>(timed_ns) -
+                                        clockOverheadNs() * static_cast<double>(timed_calls));
+    return 1e-9 * ns * (static_cast<double>(calls) / static_cast<double>(timed_calls));
+}
+
+const char *collisionProbeName(CollisionProbe p) {
+    switch (p) {
+    case CollisionProbe::IS_FREE:                     return "is_free";
+    case CollisionProbe::SEGMENT_FREE:                return "segment_free";
+    case CollisionProbe::IS_FREE_BATCH:               return "is_free_batch";
+    case CollisionProbe::SEGMENT_FREE_BATCH:          return "segment_free_batch";
+    case CollisionProbe::OBSTACLE_CONTAINS:           return "obstacle_contains";
+    case CollisionProbe::OBSTACLE_INTERSECTS_SEGMENT: return "obstacle_intersects_segment";
+    case CollisionProbe::VISIBILITY_SEGMENT:          return "visibility_segment";
+    case CollisionProbe::COUNT:                       break;
+    }
+    return "unknown";
+}
+
+#if PLANNING_COLLISION_STATS
+
+namespace {
+    using collision_stats_detail::ThreadBlock;
+
+    // 살아 있는 thread 의 block 목록과, 끝난 thread 가 남긴 합
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadBlock *> blocks;
+        CollisionStats retired;
+    };
+
+    Registry &registry() {
+        static Registry r;
+        return r;
+    }
+
+    void accumulate(CollisionStats &out, const ThreadBlock &b) {
+        for (int i = 0; i < kNumCollisionProbes; ++i) {
+            CollisionCounters &c = out.probe[i];
+            c.calls       += b.calls[i].load(std::memory_order_relaxed);
+            c.edges       += b.edges[i].load(std::memory_order_relaxed);
+            c.early_outs  += b.early_outs[i].load(std::memory_order_relaxed);
+            c.timed_calls += b.timed_calls[i].load(std::memory_order_relaxed);
+            c.timed_ns    += b.timed_ns[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void zero(ThreadBlock &b) {
+        for (int i = 0; i < kNumCollisionProbes; ++i) {
+            for (auto *c : {&b.calls[i], &b.edges[i], &b.early_outs[i], &b.timed_calls[i], &b.timed_ns[i]})
+                c->store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+collision_stats_detail::ThreadBlock::ThreadBlock() {
+    zero(*this);
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.blocks.push_back(this);
+}
+
+collision_stats_detail::ThreadBlock::~ThreadBlock() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    accumulate(r.retired, *this);
+    r.blocks.erase(std::remove(r.blocks.begin(), r.blocks.end(), this), r.blocks.end());
+}
+
+CollisionStats collisionStatsSnapshot() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    CollisionStats out = r.retired;
+    for (const ThreadBlock *b : r.blocks)
+        accumulate(out, *b);
+    return out;
+}
+
+void resetCollisionStats() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = CollisionStats();
+    for (ThreadBlock *b : r.blocks)
+        zero(*b);
+}
+
+#else
+
+CollisionStats collisionStatsSnapshot() {
+    return CollisionStats();
+}
+
+void resetCollisionStats() {}
+
+#endif
+
+void writeCollisionStatsJson(std::ostream &os, const CollisionStats &stats, int indent) {
+    const std::string pad(indent, ' ');
+    os << "{\n";
+    os << pad << "  \"enabled\": " << (collisionStatsEnabled() ? "true" : "false") << ",\n";
+    os << pad << "  \"probes\": {\n";
+    for (int i = 0; i < kNumCollisionProbes; ++i) {
+        const CollisionCounters &c = stats.probe[i];
+        os << pad << "    \"" << collisionProbeName(static_cast<CollisionProbe>(i)) << "\": {"
+           << "\"calls\": " << c.calls
+           << ", \"edges\": " << c.edges
+           << ", \"early_outs\": " << c.early_outs
+           << ", \"timed_calls\": " << c.timed_calls
+           << ", \"time_s\": " << c.seconds() << "}"
+           << (i + 1 < kNumCollisionProbes ? "," : "") << "\n";
+    }
+    os << pad << "  }\n";
+    os << pad << "}";
+}
@@ -0,0 +1,143 @@
+// /src/env/collision_stats.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// collision query 계측 counter
+// - thread 마다 자기 block 에만 쓰고 (lock 없음), snapshot 에서 모든 thread 를 합친다 (끝난 thread 포함)
+// - CMake 옵션 PLANNING_COLLISION_STATS=OFF 면 probe / countEdgeTests 가 빈 inline 이 되어 비용이 없다
+// - 시간은 probe 마다 kTimingPeriod 번에 한 번만 재고 calls 비율로 늘려 추정한다
+//   (clock 읽기가 작은 polygon 의 contains 한 번보다 비싸므로)
+#ifndef PLANNING_COLLISION_STATS
+#define PLANNING_COLLISION_STATS 0
+#endif
+
+enum class CollisionProbe : int {
+    IS_FREE,                      // Environment::isFree
+    SEGMENT_FREE,                 // Environment::segmentFree
+    IS_FREE_BATCH,                // Environment::isFreeBatch (64개 묶음 하나가 call 한 번)
+    SEGMENT_FREE_BATCH,           // Environment::segmentFreeBatch (64개 묶음 하나가 call 한 번)
+    OBSTACLE_CONTAINS,            // Obstacle::contains
+    OBSTACLE_INTERSECTS_SEGMENT,  // Obstacle::intersectsSegment
+    VISIBILITY_SEGMENT,           // segmentFreeBatch(SegmentContact::SHARED_VERTEX) 의 64개 묶음 하나 (visibility graph)
+    COUNT
+};
+
+constexpr int kNumCollisionProbes = static_cast<int>(CollisionProbe::COUNT);
+
+struct CollisionCounters {
+    std::uint64_t calls = 0;
+    std::uint64_t edges = 0;        // 호출 안에서 exact 검사한 edge 수 (안쪽 probe 의 것도 포함)
+    std::uint64_t early_outs = 0;   // edge 검사 없이 답한 호출 (intersectsSegment 는 마지막 edge 전에 hit)
+    std::uint64_t timed_calls = 0;  // 시간을 잰 호출 수
+    std::uint64_t timed_ns = 0;
+
+    // timed_ns 를 calls / timed_calls 로 늘린 누적 시간 추정치
+    double seconds() const;
+};
+
+struct CollisionStats {
+    CollisionCounters probe[kNumCollisionProbes];
+
+    const CollisionCounters &operator[](CollisionProbe p) const { return probe[static_cast<int>(p)]; }
+};
+
+const char *collisionProbeName(CollisionProbe p);
+constexpr bool collisionStatsEnabled() { return PLANNING_COLLISION_STATS != 0; }
+
+// 모든 thread 의 합. 다른 thread 가 query 중이면 그 thread 의 값은 조금 늦을 수 있다
+CollisionStats collisionStatsSnapshot();
+// query 가 돌고 있지 않을 때 호출
+void resetCollisionStats();
+// { "enabled": ..., "probes": { "is_free": { "calls": ..., ... }, ... } }
+void writeCollisionStatsJson(std::ostream &os, const CollisionStats &stats, int indent = 0);
+
+#if PLANNING_COLLISION_STATS
+
+namespace collision_stats_detail {
+    constexpr std::uint64_t kTimingPeriod = 64;
+
+    struct ThreadBlock {
+        // 주인 thread 만 쓰므로 relaxed load + store (x86 에서는 보통 mov)
+        std::atomic<std::uint64_t> calls[kNumCollisionProbes];
+        std::atomic<std::uint64_t> edges[kNumCollisionProbes];
+        std::atomic<std::uint64_t> early_outs[kNumCollisionProbes];
+        std::atomic<std::uint64_t> timed_calls[kNumCollisionProbes];
+        std::atomic<std::uint64_t> timed_ns[kNumCollisionProbes];
+        std::uint64_t edge_tally = 0;  // 이 thread 가 검사한 edge 의 누계 (probe 가 차이를 가져간다)
+
+        ThreadBlock();
+        ~ThreadBlock();
+        ThreadBlock(const ThreadBlock &) = delete;
+        ThreadBlock &operator=(const ThreadBlock &) = delete;
+    };
+
+    inline ThreadBlock &localBlock() {
+        static thread_local ThreadBlock block;
+        return block;
+    }
+
+    inline void bump(std::atomic<std::uint64_t> &c, std::uint64_t n) {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+}
+
+inline void countEdgeTests(std::uint64_t n) {
+    collision_stats_detail::localBlock().edge_tally += n;
+}
+
+// 함수 맨 앞에 두면 scope 를 벗어날 때 한 번의 호출로 기록한다
+class CollisionProbeScope {
+public:
+    explicit CollisionProbeScope(CollisionProbe p)
+        : block_(collision_stats_detail::localBlock()), p_(static_cast<int>(p)),
+          edge_start_(block_.edge_tally) {
+        const std::uint64_t n = block_.calls[p_].load(std::memory_order_relaxed);
+        block_.calls[p_].store(n + 1, std::memory_order_relaxed);
+        timed_ = (n % collision_stats_detail::kTimingPeriod) == 0;
+        if (timed_)
+            t_start_ = std::chrono::steady_clock::now();
+    }
+
+    ~CollisionProbeScope() {
+        using namespace collision_stats_detail;
+        const std::uint64_t edges = block_.edge_tally - edge_start_;
+        bump(block_.edges[p_], edges);
+        if (early_ || edges == 0)
+            bump(block_.early_outs[p_], 1);
+        if (timed_) {
+            auto dt = std::chrono::steady_clock::now() - t_start_;
+            bump(block_.timed_calls[p_], 1);
+            bump(block_.timed_ns[p_], static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
+        }
+    }
+
+    CollisionProbeScope(const CollisionProbeScope &) = delete;
+    CollisionProbeScope &operator=(const CollisionProbeScope &) = delete;
+
+    // edge 를 검사했더라도 early-out 으로 센다
+    void earlyOut() { early_ = true; }
+
+private:
+    collision_stats_detail::ThreadBlock &block_;
+    int p_;
+    std::uint64_t edge_start_;
+    bool timed_ = false;
+    bool early_ = false;
+    std::chrono::steady_clock::time_point t_start_;
+};
+
+#else
+
+inline void countEdgeTests(std::uint64_t) {}
+
+class CollisionProbeScope {
+public:
+    explicit CollisionProbeScope(CollisionProbe) {}
+    void earlyOut() {}
+};
+
+#endif
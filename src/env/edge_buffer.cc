@@ -0,0 +1,332 @@
+// /src/env/edge_buffer.cc
+#include "edge_buffer.h"
+#include "collision_stats.h"
+#include "geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define EDGE_BUFFER_HAS_AVX2 1
+#endif
+
+namespace {
+    // edge i 한 개에 대한 scalar 검사
+    // segmentsIntersect(a, b, q0, q1) 과 같은 exact 판정
+    bool edgeHit(const EdgeBuffer &e, std::size_t i, const Vec2 &a, const Vec2 &b) {
+        const Vec2 q0(e.x0[i], e.y0[i]);
+        const Vec2 q1(e.x1[i], e.y1[i]);
+        return segmentsIntersect(a, b, q0, q1);
+    }
+
+    bool anyHitScalar(const EdgeBuffer &e, const Vec2 &a, const Vec2 &b,
+                      std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (edgeHit(e, i, a, b)) {
+                countEdgeTests(i - begin + 1);
+                return true;
+            }
+        }
+        countEdgeTests(end - begin);
+        return false;
+    }
+
+    // SegmentContact::SHARED_VERTEX 용: 선분과 끝점을 공유하는 edge 는 건너뛴다
+    bool anyHitSkippingShared(const EdgeBuffer &e, const Vec2 &a, const Vec2 &b,
+                              std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const Vec2 q0(e.x0[i], e.y0[i]);
+            const Vec2 q1(e.x1[i], e.y1[i]);
+            if (sharesEndpoint(a, b, q0, q1))
+                continue;
+            if (segmentsIntersect(a, b, q0, q1)) {
+                countEdgeTests(i - begin + 1);
+                return true;
+            }
+        }
+        countEdgeTests(end - begin);
+        return false;
+    }
+
+#ifdef EDGE_BUFFER_HAS_AVX2
+    // orient2d 의 semi-static filter 를 4 lane 에 그대로: (u x v) 의 부호가 filter 로 확정되면 1/-1 mask,
+    // 확정되지 않으면 (거의 collinear, 또는 filter 범위 밖) 두 mask 모두 0
+    __attribute__((target("avx2")))
+    inline void filteredSign(__m256d ux, __m256d uy, __m256d vx, __m256d vy,
+                             __m256d &pos, __m256d &neg) {
+        const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+        const __m256d det = _mm256_sub_pd(_mm256_mul_pd(ux, vy), _mm256_mul_pd(uy, vx));
+        const __m256d mx = _mm256_max_pd(_mm256_and_pd(ux, abs_mask), _mm256_and_pd(vx, abs_mask));
+        const __m256d my = _mm256_max_pd(_mm256_and_pd(uy, abs_mask), _mm256_and_pd(vy, abs_mask));
+        const __m256d in_range = _mm256_and_pd(
+            _mm256_cmp_pd(_mm256_min_pd(mx, my), _mm256_set1_pd(predicates::kFilterMin), _CMP_GE_OQ),
+            _mm256_cmp_pd(_mm256_max_pd(mx, my), _mm256_set1_pd(predicates::kFilterMax), _CMP_LT_OQ));
+        const __m256d eps = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(predicates::kOrientFilter), mx), my);
+        pos = _mm256_and_pd(in_range, _mm256_cmp_pd(det, eps, _CMP_GT_OQ));
+        neg = _mm256_and_pd(in_range, _mm256_cmp_pd(det, _mm256_sub_pd(_mm256_setzero_pd(), eps), _CMP_LT_OQ));
+    }
+
+    // edge 4개를 한 번에: filter 로 확정되는 proper crossing 은 vector 로 판정하고,
+    // 부호가 확정되지 않은 (collinear/touch 후보) lane 만 scalar exact 로 다시 본다
+    __attribute__((target("avx2")))
+    bool anyHitAVX2(const EdgeBuffer &e, const Vec2 &a, const Vec2 &b,
+                    std::size_t begin, std::size_t end) {
+        const __m256d ax = _mm256_set1_pd(a.x);
+        const __m256d ay = _mm256_set1_pd(a.y);
+        const __m256d bx = _mm256_set1_pd(b.x);
+        const __m256d by = _mm256_set1_pd(b.y);
+        const __m256d ux = _mm256_set1_pd(b.x - a.x);
+        const __m256d uy = _mm256_set1_pd(b.y - a.y);
+
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m256d x0 = _mm256_loadu_pd(&e.x0[i]);
+            __m256d y0 = _mm256_loadu_pd(&e.y0[i]);
+            __m256d x1 = _mm256_loadu_pd(&e.x1[i]);
+            __m256d y1 = _mm256_loadu_pd(&e.y1[i]);
+            __m256d dx = _mm256_loadu_pd(&e.dx[i]);
+            __m256d dy = _mm256_loadu_pd(&e.dy[i]);
+
+            // orient2d(a, b, q0), orient2d(a, b, q1), orient2d(q0, q1, a), orient2d(q0, q1, b)
+            __m256d p1, n1, p2, n2, p3, n3, p4, n4;
+            filteredSign(ux, uy, _mm256_sub_pd(x0, ax), _mm256_sub_pd(y0, ay), p1, n1);
+            filteredSign(ux, uy, _mm256_sub_pd(x1, ax), _mm256_sub_pd(y1, ay), p2, n2);
+            filteredSign(dx, dy, _mm256_sub_pd(ax, x0), _mm256_sub_pd(ay, y0), p3, n3);
+            filteredSign(dx, dy, _mm256_sub_pd(bx, x0), _mm256_sub_pd(by, y0), p4, n4);
+
+            __m256d straddle_p = _mm256_or_pd(_mm256_and_pd(p1, n2), _mm256_and_pd(n1, p2));
+            __m256d straddle_q = _mm256_or_pd(_mm256_and_pd(p3, n4), _mm256_and_pd(n3, p4));
+            if (_mm256_movemask_pd(_mm256_and_pd(straddle_p, straddle_q))) {
+                countEdgeTests(i + 4 - begin);
+                return true;
+            }
+
+            // 어느 부호라도 filter 로 확정되지 않은 lane
+            int decided = _mm256_movemask_pd(_mm256_or_pd(p1, n1)) &
+                          _mm256_movemask_pd(_mm256_or_pd(p2, n2)) &
+                          _mm256_movemask_pd(_mm256_or_pd(p3, n3)) &
+                          _mm256_movemask_pd(_mm256_or_pd(p4, n4));
+            int undecided = ~decided & 0xF;
+            while (undecided) {
+                int lane = __builtin_ctz(undecided);
+                if (edgeHit(e, i + lane, a, b)) {
+                    countEdgeTests(i + 4 - begin);
+                    return true;
+                }
+                undecided &= undecided - 1;
+            }
+        }
+        for (; i < end; ++i) {
+            if (edgeHit(e, i, a, b)) {
+                countEdgeTests(i - begin + 1);
+                return true;
+            }
+        }
+        countEdgeTests(end - begin);
+        return false;
+    }
+#endif
+
+    bool cpuHasAVX2() {
+#ifdef EDGE_BUFFER_HAS_AVX2
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    using KernelFn = bool (*)(const EdgeBuffer &, const Vec2 &, const Vec2 &,
+                              std::size_t, std::size_t);
+
+    struct KernelState {
+        EdgeKernel kind;
+        KernelFn   fn;
+    };
+
+    KernelState resolve(EdgeKernel kernel) {
+#ifdef EDGE_BUFFER_HAS_AVX2
+        if (kernel != EdgeKernel::SCALAR && cpuHasAVX2())
+            return {EdgeKernel::AVX2, &anyHitAVX2};
+#endif
+        (void)kernel;
+        return {EdgeKernel::SCALAR, &anyHitScalar};
+    }
+
+    KernelState &kernelState() {
+        static KernelState state = resolve(EdgeKernel::AUTO);
+        return state;
+    }
+
+    // 이 개수 이하로 줄어든 구간은 SHARED_VERTEX 검사를 scalar 로 한다
+    constexpr std::size_t kSharedLeaf = 16;
+
+    // vector kernel 은 끝점 공유 edge 도 hit 로 보므로, hit 가 난 구간을 반씩 나눠 hit 쪽만 내려간다
+    // (선분 끝점에 붙은 edge 는 몇 개뿐이라 대부분의 구간은 kernel 한 번으로 끝난다)
+    bool anyHitShared(const KernelState &k, const EdgeBuffer &e, const Vec2 &a, const Vec2 &b,
+                      std::size_t begin, std::size_t end) {
+        if (k.kind == EdgeKernel::SCALAR || end - begin <= kSharedLeaf)
+            return anyHitSkippingShared(e, a, b, begin, end);
+        if (!k.fn(e, a, b, begin, end))
+            return false;
+        const std::size_t mid = begin + (end - begin) / 2;
+        return anyHitShared(k, e, a, b, begin, mid) || anyHitShared(k, e, a, b, mid, end);
+    }
+
+    bool anyHit(const KernelState &k, const EdgeBuffer &e, const Vec2 &a, const Vec2 &b,
+                std::size_t begin, std::size_t end, SegmentContact contact) {
+        if (contact == SegmentContact::BLOCKED)
+            return k.fn(e, a, b, begin, end);
+        return anyHitShared(k, e, a, b, begin, end);
+    }
+
+    // 16 bit 두 개의 bit 를 번갈아 섞는다 (x 가 짝수 bit)
+    std::uint32_t spreadBits(std::uint32_t v) {
+        v &= 0xFFFFu;
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    }
+
+    std::uint32_t mortonCode(std::uint32_t x, std::uint32_t y) {
+        return spreadBits(x) | (spreadBits(y) << 1);
+    }
+}
+
+EdgeKernel edgeKernelFromString(const std::string &name) {
+    if (name == "auto")
+        return EdgeKernel::AUTO;
+    if (name == "scalar")
+        return EdgeKernel::SCALAR;
+    if (name == "avx2")
+        return EdgeKernel::AVX2;
+    throw std::runtime_error("Unknown edge kernel: " + name);
+}
+
+const char *edgeKernelName(EdgeKernel kernel) {
+    switch (kernel) {
+    case EdgeKernel::AUTO:   return "auto";
+    case EdgeKernel::SCALAR: return "scalar";
+    case EdgeKernel::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+EdgeKernel selectEdgeKernel(EdgeKernel kernel) {
+    kernelState() = resolve(kernel);
+    return kernelState().kind;
+}
+
+EdgeKernel activeEdgeKernel() {
+    return kernelState().kind;
+}
+
+void EdgeBuffer::clear() {
+    x0.clear(); y0.clear();
+    x1.clear(); y1.clear();
+    dx.clear(); dy.clear();
+    begin_.clear();
+    end_.clear();
+    tile_box_.clear();
+}
+
+void EdgeBuffer::build(const std::vector<Obstacle> &obstacles) {
+    clear();
+    std::size_t total = 0;
+    AABB world;
+    std::vector<Vec2> centers(obstacles.size());
+    for (std::size_t oi = 0; oi < obstacles.size(); ++oi) {
+        const auto &obs = obstacles[oi];
+        total += obs.pts.size();
+        AABB box;
+        for (const auto &p : obs.pts)
+            box.expand(p);
+        if (!box.empty()) {
+            centers[oi] = Vec2(0.5 * (box.min.x + box.max.x), 0.5 * (box.min.y + box.max.y));
+            world.expand(centers[oi]);
+        }
+    }
+    for (auto *v : {&x0, &y0, &x1, &y1, &dx, &dy})
+        v->reserve(total);
+
+    // 중심을 16 bit 격자로 양자화해서 x/y bit 를 번갈아 섞은 code 순서로 놓는다
+    std::vector<std::pair<std::uint32_t, std::size_t>> order(obstacles.size());
+    const double sx = world.empty() || world.max.x <= world.min.x ? 0.0 : 65535.0 / (world.max.x - world.min.x);
+    const double sy = world.empty() || world.max.y <= world.min.y ? 0.0 : 65535.0 / (world.max.y - world.min.y);
+    for (std::size_t oi = 0; oi < obstacles.size(); ++oi) {
+        const auto qx = static_cast<std::uint32_t>((centers[oi].x - world.min.x) * sx);
+        const auto qy = static_cast<std::uint32_t>((centers[oi].y - world.min.y) * sy);
+        order[oi] = {obstacles[oi].pts.empty() ? 0u : mortonCode(qx, qy), oi};
+    }
+    std::sort(order.begin(), order.end());
+
+    begin_.resize(obstacles.size());
+    end_.resize(obstacles.size());
+    for (const auto &o : order) {
+        begin_[o.second] = x0.size();
+        appendEdges(obstacles[o.second]);
+        end_[o.second] = x0.size();
+    }
+}
+
+void EdgeBuffer::append(const Obstacle &obs) {
+    begin_.push_back(x0.size());
+    appendEdges(obs);
+    end_.push_back(x0.size());
+}
+
+void EdgeBuffer::appendEdges(const Obstacle &obs) {
+    int n = static_cast<int>(obs.pts.size());
+    for (int i = 0; i < n; ++i) {
+        const Vec2 &c = obs.pts[i];
+        const Vec2 &d = obs.pts[(i + 1) % n];
+        x0.push_back(c.x);
+        y0.push_back(c.y);
+        x1.push_back(d.x);
+        y1.push_back(d.y);
+        dx.push_back(d.x - c.x);
+        dy.push_back(d.y - c.y);
+        if ((x0.size() - 1) % kTileSize == 0)
+            tile_box_.emplace_back();
+        tile_box_.back().expand(c);
+        tile_box_.back().expand(d);
+    }
+}
+
+bool EdgeBuffer::anyIntersects(const Vec2 &a, const Vec2 &b,
+                               std::size_t begin, std::size_t end, SegmentContact contact) const {
+    return anyHit(kernelState(), *this, a, b, begin, end, contact);
+}
+
+std::uint64_t EdgeBuffer::intersectsMany(const Segment *segs, std::uint64_t lanes,
+                                         SegmentContact contact) const {
+    // 선분 bbox 는 한 번만 계산 (tile bbox 와의 비교는 비교 연산뿐이라 exact 하고 보수적)
+    AABB seg_box[64];
+    for (std::uint64_t r = lanes; r; r &= r - 1) {
+        const int l = __builtin_ctzll(r);
+        seg_box[l] = AABB();
+        seg_box[l].expand(segs[l].a);
+        seg_box[l].expand(segs[l].b);
+    }
+
+    const KernelState kernel = kernelState();
+    std::uint64_t alive = lanes;
+    std::uint64_t hit = 0;
+    for (std::size_t t = 0; t < tile_box_.size() && alive; ++t) {
+        const std::size_t begin = t * kTileSize;
+        const std::size_t end = std::min(begin + kTileSize, size());
+        for (std::uint64_t r = alive; r; r &= r - 1) {
+            const int l = __builtin_ctzll(r);
+            if (!tile_box_[t].overlaps(seg_box[l]))
+                continue;
+            if (anyHit(kernel, *this, segs[l].a, segs[l].b, begin, end, contact)) {
+                hit |= std::uint64_t(1) << l;
+                alive &= ~(std::uint64_t(1) << l);
+            }
+        }
+    }
+    return hit;
+}
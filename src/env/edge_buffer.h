@@ -0,0 +1,69 @@
+// /src/env/edge_buffer.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "batch.h"
+#include "obstacle.h"
+
+// segment-vs-edges kernel 종류
+enum class EdgeKernel {
+    AUTO,    // CPU 가 지원하면 AVX2, 아니면 SCALAR
+    SCALAR,
+    AVX2     // double 4개씩
+};
+
+EdgeKernel edgeKernelFromString(const std::string &name);
+const char *edgeKernelName(EdgeKernel kernel);
+
+// 프로세스 전체에서 쓸 kernel 선택. 실제로 선택된 kernel 을 반환
+// (AVX2 를 요청했지만 CPU 가 지원하지 않으면 SCALAR)
+EdgeKernel selectEdgeKernel(EdgeKernel kernel);
+EdgeKernel activeEdgeKernel();
+
+// 모든 obstacle edge 를 structure-of-arrays 로 펼친 buffer
+// edge i 는 (x0[i], y0[i]) -> (x1[i], y1[i]), dx/dy 는 미리 계산한 방향
+// (x1/y1 도 같이 두는 이유: Obstacle::segmentsIntersect 와 bit 단위로 같은 답을 내기 위해)
+// build 는 obstacle 을 bbox 중심의 Morton 순서로 놓아서 연속한 edge 들 (tile) 이 공간적으로 모이게 한다
+// (obstacle 하나의 edge 는 여전히 연속이고, append 한 것은 끝에 붙는다)
+class EdgeBuffer {
+public:
+    // 연속한 이 개수의 edge 를 tile 하나로 묶어 bbox 를 둔다 (6 배열 x 256 x 8 byte = 12KB, L1 안)
+    static constexpr std::size_t kTileSize = 256;
+
+    std::vector<double> x0, y0, x1, y1, dx, dy;
+
+    void build(const std::vector<Obstacle> &obstacles);
+    void clear();
+    // obstacle 하나의 edge 를 끝에 추가 (index 는 obstacleCount())
+    void append(const Obstacle &obs);
+
+    std::size_t obstacleCount() const { return begin_.size(); }
+
+    std::size_t size() const { return x0.size(); }
+
+    // obstacle oi 의 edge 는 [obstacleBegin(oi), obstacleEnd(oi))
+    std::size_t obstacleBegin(int oi) const { return begin_[oi]; }
+    std::size_t obstacleEnd(int oi) const { return end_[oi]; }
+
+    // [begin, end) 의 edge 중 선분 (a,b)와 교차하는 것이 있는지
+    // SHARED_VERTEX 는 선분과 끝점을 공유하는 edge 를 빼고 본다
+    bool anyIntersects(const Vec2 &a, const Vec2 &b, std::size_t begin, std::size_t end,
+                       SegmentContact contact = SegmentContact::BLOCKED) const;
+    bool anyIntersects(const Vec2 &a, const Vec2 &b) const {
+        return anyIntersects(a, b, 0, size());
+    }
+
+    // segs[i] 중 lanes 의 bit 가 켜진 선분들을 한꺼번에 검사해서, 어떤 edge 와 교차하는 선분의 bit 를 반환
+    // tile 마다 bbox 가 겹치는 선분들에만 kernel 을 돌리므로 buffer 는 선분 수와 상관없이 한 번만 읽는다
+    // (선분 하나씩 anyIntersects 를 부르면 선분마다 buffer 전체를 다시 읽는다)
+    std::uint64_t intersectsMany(const Segment *segs, std::uint64_t lanes,
+                                 SegmentContact contact = SegmentContact::BLOCKED) const;
+
+private:
+    void appendEdges(const Obstacle &obs);
+
+    std::vector<std::size_t> begin_, end_;  // obstacle 별 edge 구간 (obstacle index 순)
+    std::vector<AABB> tile_box_;  // tile t = edge [t * kTileSize, (t + 1) * kTileSize) 의 bbox
+};
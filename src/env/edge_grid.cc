@@ -0,0 +1,224 @@
+// /src/env/edge_grid.cc
+#include "edge_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // 등록 margin: cell 좌표 계산과 cell-선분 clipping 의 부동소수점 반올림 때문에
+    // edge 가 실제로 닿는 cell 을 빠뜨리지 않도록 box 를 조금 키운다
+    constexpr double kMargin = 1e-6;
+    // 한 축당 cell 개수 상한 (메모리 보호)
+    constexpr int kMaxCellsPerAxis = 2048;
+}
+
+void EdgeGrid::clear() {
+    bounds_ = AABB();
+    cell_ = 0.0;
+    nx_ = ny_ = 0;
+    cells_.clear();
+}
+
+int EdgeGrid::clampX(double x) const {
+    int i = static_cast<int>(std::floor((x - bounds_.min.x) / cell_));
+    return std::max(0, std::min(i, nx_ - 1));
+}
+
+int EdgeGrid::clampY(double y) const {
+    int i = static_cast<int>(std::floor((y - bounds_.min.y) / cell_));
+    return std::max(0, std::min(i, ny_ - 1));
+}
+
+void EdgeGrid::build(const std::vector<Obstacle> &obstacles, const AABB &cover,
+                     double cell_size) {
+    clear();
+
+    std::size_t num_edges = 0;
+    double total_len = 0.0;
+    for (const auto &obs : obstacles) {
+        bounds_.expand(obs.bbox);
+        int n = static_cast<int>(obs.pts.size());
+        for (int i = 0; i < n; ++i) {
+            const Vec2 &a = obs.pts[i];
+            const Vec2 &b = obs.pts[(i + 1) % n];
+            total_len += std::hypot(b.x - a.x, b.y - a.y);
+        }
+        num_edges += obs.pts.size();
+    }
+    if (!cover.empty())
+        bounds_.expand(cover);
+
+    if (bounds_.empty()) {
+        // obstacle 도 cover 도 없으면 1x1 빈 grid
+        bounds_ = AABB(Vec2(0.0, 0.0), Vec2(1.0, 1.0));
+        cell_ = 1.0;
+        nx_ = ny_ = 1;
+        cells_.assign(1, Cell());
+        return;
+    }
+    bounds_ = bounds_.inflated(kMargin);
+
+    double w = bounds_.max.x - bounds_.min.x;
+    double h = bounds_.max.y - bounds_.min.y;
+    if (cell_size <= 0.0) {
+        // cell 하나에 edge 가 평균 1~2개 들어가도록
+        double edges = static_cast<double>(std::max<std::size_t>(num_edges, 1));
+        double avg_len = total_len / edges;
+        cell_size = std::max(avg_len, std::sqrt(w * h / edges));
+    }
+    cell_size = std::max({cell_size, w / kMaxCellsPerAxis, h / kMaxCellsPerAxis});
+    cell_ = cell_size;
+    nx_ = std::max(1, static_cast<int>(std::ceil(w / cell_)));
+    ny_ = std::max(1, static_cast<int>(std::ceil(h / cell_)));
+    cells_.assign(static_cast<std::size_t>(nx_) * ny_, Cell());
+
+    for (int oi = 0; oi < static_cast<int>(obstacles.size()); ++oi)
+        registerObstacle(obstacles[oi], oi);
+}
+
+void EdgeGrid::cellRange(const Obstacle &obs, int &ix0, int &ix1, int &iy0, int &iy1) const {
+    AABB ob = obs.bbox.inflated(kMargin);
+    ix0 = clampX(ob.min.x);
+    ix1 = clampX(ob.max.x);
+    iy0 = clampY(ob.min.y);
+    iy1 = clampY(ob.max.y);
+}
+
+void EdgeGrid::registerObstacle(const Obstacle &obs, int oi) {
+    int n = static_cast<int>(obs.pts.size());
+    if (n == 0) return;
+
+    // 1) edge 등록: edge bbox 범위의 cell 중 실제로 edge 가 지나가는 cell 만
+    for (int i = 0; i < n; ++i) {
+        const Vec2 &a = obs.pts[i];
+        const Vec2 &b = obs.pts[(i + 1) % n];
+        AABB eb;
+        eb.expand(a);
+        eb.expand(b);
+        eb = eb.inflated(kMargin);
+        int ix0 = clampX(eb.min.x), ix1 = clampX(eb.max.x);
+        int iy0 = clampY(eb.min.y), iy1 = clampY(eb.max.y);
+        for (int iy = iy0; iy <= iy1; ++iy) {
+            for (int ix = ix0; ix <= ix1; ++ix) {
+                AABB cb(Vec2(bounds_.min.x + ix * cell_, bounds_.min.y + iy * cell_),
+                        Vec2(bounds_.min.x + (ix + 1) * cell_, bounds_.min.y + (iy + 1) * cell_));
+                if (!cb.inflated(kMargin).overlapsSegment(a, b))
+                    continue;
+                cells_[cellIndex(ix, iy)].edges.push_back({oi, i});
+            }
+        }
+    }
+
+    // 2) obstacle 등록: point query 용 (bbox 기준)
+    int ix0, ix1, iy0, iy1;
+    cellRange(obs, ix0, ix1, iy0, iy1);
+    for (int iy = iy0; iy <= iy1; ++iy)
+        for (int ix = ix0; ix <= ix1; ++ix)
+            cells_[cellIndex(ix, iy)].obstacles.push_back(oi);
+}
+
+bool EdgeGrid::insertObstacle(const std::vector<Obstacle> &obstacles, int oi) {
+    const Obstacle &obs = obstacles[oi];
+    if (!built() || obs.pts.empty())
+        return built();
+    if (!bounds_.contains(obs.bbox.min) || !bounds_.contains(obs.bbox.max))
+        return false;
+    registerObstacle(obs, oi);
+    return true;
+}
+
+void EdgeGrid::removeObstacle(const Obstacle &obs, int oi) {
+    if (!built() || obs.pts.empty())
+        return;
+    int ix0, ix1, iy0, iy1;
+    cellRange(obs, ix0, ix1, iy0, iy1);
+    for (int iy = iy0; iy <= iy1; ++iy) {
+        for (int ix = ix0; ix <= ix1; ++ix) {
+            Cell &c = cells_[cellIndex(ix, iy)];
+            c.edges.erase(std::remove_if(c.edges.begin(), c.edges.end(),
+                                         [oi](const EdgeRef &r) { return r.obs == oi; }),
+                          c.edges.end());
+            c.obstacles.erase(std::remove(c.obstacles.begin(), c.obstacles.end(), oi),
+                              c.obstacles.end());
+        }
+    }
+}
+
+void EdgeGrid::relabelObstacle(const Obstacle &obs, int old_oi, int new_oi) {
+    if (!built() || obs.pts.empty())
+        return;
+    int ix0, ix1, iy0, iy1;
+    cellRange(obs, ix0, ix1, iy0, iy1);
+    for (int iy = iy0; iy <= iy1; ++iy) {
+        for (int ix = ix0; ix <= ix1; ++ix) {
+            Cell &c = cells_[cellIndex(ix, iy)];
+            for (EdgeRef &r : c.edges)
+                if (r.obs == old_oi) r.obs = new_oi;
+            for (int &o : c.obstacles)
+                if (o == old_oi) o = new_oi;
+        }
+    }
+}
+
+bool EdgeGrid::segmentHits(const std::vector<Obstacle> &obstacles, const Vec2 &a, const Vec2 &b,
+                           SegmentContact contact) const {
+    if (!built())
+        return false;
+
+    double t0, t1;
+    if (!bounds_.clipSegment(a, b, t0, t1))
+        return false;  // 모든 edge 는 bounds 안에 있다
+
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    int ix = clampX(a.x + t0 * dx);
+    int iy = clampY(a.y + t0 * dy);
+
+    // Amanatides-Woo DDA
+    int step_x = (dx > 0.0) ? 1 : (dx < 0.0 ? -1 : 0);
+    int step_y = (dy > 0.0) ? 1 : (dy < 0.0 ? -1 : 0);
+    double t_max_x = inf, t_max_y = inf;
+    double t_delta_x = inf, t_delta_y = inf;
+    if (step_x != 0) {
+        double edge_x = bounds_.min.x + (ix + (step_x > 0 ? 1 : 0)) * cell_;
+        t_max_x = (edge_x - a.x) / dx;
+        t_delta_x = cell_ / std::fabs(dx);
+    }
+    if (step_y != 0) {
+        double edge_y = bounds_.min.y + (iy + (step_y > 0 ? 1 : 0)) * cell_;
+        t_max_y = (edge_y - a.y) / dy;
+        t_delta_y = cell_ / std::fabs(dy);
+    }
+
+    while (true) {
+        for (const EdgeRef &r : cells_[cellIndex(ix, iy)].edges) {
+            if (obstacles[r.obs].edgeIntersectsSegment(r.edge, a, b, contact))
+                return true;
+        }
+
+        if (t_max_x > t1 && t_max_y > t1)
+            break;
+        if (t_max_x < t_max_y) {
+            ix += step_x;
+            if (ix < 0 || ix >= nx_) break;
+            t_max_x += t_delta_x;
+        } else {
+            iy += step_y;
+            if (iy < 0 || iy >= ny_) break;
+            t_max_y += t_delta_y;
+        }
+    }
+    return false;
+}
+
+bool EdgeGrid::pointInside(const std::vector<Obstacle> &obstacles, const Vec2 &p) const {
+    if (!built() || !bounds_.contains(p))
+        return false;
+    for (int oi : cells_[cellIndex(clampX(p.x), clampY(p.y))].obstacles) {
+        if (obstacles[oi].contains(p))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+// /src/env/edge_grid.h
+#pragma once
+#include <vector>
+#include "aabb.h"
+#include "obstacle.h"
+
+// obstacle edge 들을 uniform grid 에 담아두는 spatial index
+// - segment query 는 DDA 로 지나가는 cell 만 방문
+// - point query 는 점이 속한 cell 하나만 확인
+// brute-force 검사와 같은 답을 내도록 edge/obstacle 등록은 margin 만큼 보수적으로 한다
+class EdgeGrid {
+public:
+    struct EdgeRef {
+        int obs;   // obstacle index
+        int edge;  // obstacle 안에서의 edge index (pts[edge] -> pts[edge+1])
+    };
+
+    EdgeGrid() = default;
+
+    // grid 는 obstacle 들과 cover 를 모두 덮는다 (나중에 cover 안에 추가되는 obstacle 은 incremental 로)
+    // cell_size <= 0 이면 edge 개수와 평균 길이로부터 자동 결정
+    void build(const std::vector<Obstacle> &obstacles, const AABB &cover = AABB(),
+               double cell_size = 0.0);
+    void clear();
+
+    // 점진적 갱신: obstacles[oi] 의 edge/bbox 를 cell 에 등록 / 제거
+    // insert 는 obstacle 이 grid 범위를 벗어나면 false (호출하는 쪽에서 build 다시)
+    bool insertObstacle(const std::vector<Obstacle> &obstacles, int oi);
+    void removeObstacle(const Obstacle &obs, int oi);
+    // obs 의 등록 정보를 old_oi -> new_oi 로 바꾼다 (swap-and-pop 용)
+    void relabelObstacle(const Obstacle &obs, int old_oi, int new_oi);
+
+    bool built() const { return nx_ > 0; }
+
+    // 선분 (a,b)가 어떤 obstacle edge 와 교차하는지
+    bool segmentHits(const std::vector<Obstacle> &obstacles, const Vec2 &a, const Vec2 &b,
+                     SegmentContact contact = SegmentContact::BLOCKED) const;
+
+    // p 가 어떤 obstacle 내부에 있는지
+    bool pointInside(const std::vector<Obstacle> &obstacles, const Vec2 &p) const;
+
+    double cellSize() const { return cell_; }
+
+private:
+    struct Cell {
+        std::vector<EdgeRef> edges;
+        std::vector<int>     obstacles;  // bbox 가 cell 과 겹치는 obstacle
+    };
+
+    int cellIndex(int ix, int iy) const { return iy * nx_ + ix; }
+    int clampX(double x) const;
+    int clampY(double y) const;
+    void registerObstacle(const Obstacle &obs, int oi);
+    // obs 의 bbox 가 걸치는 cell 범위
+    void cellRange(const Obstacle &obs, int &ix0, int &ix1, int &iy0, int &iy1) const;
+
+    AABB   bounds_;
+    double cell_ = 0.0;
+    int    nx_ = 0;
+    int    ny_ = 0;
+    std::vector<Cell> cells_;
+};
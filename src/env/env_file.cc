@@ -0,0 +1,371 @@
+// /src/env/env_file.cc
+#include "env_file.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // binary 파일 layout (little-endian, 모든 section 은 8 byte 정렬)
+    //   FileHeader
+    //   offsets  : uint64[obstacle_count + 1]   obstacle i 의 vertex 는 [offsets[i], offsets[i+1])
+    //   vertices : double[2 * vertex_count]     x, y 순서
+    //   bboxes   : double[4 * obstacle_count]   min.x, min.y, max.x, max.y   (kHasBBoxes)
+    //   bvh      : DiskBVHNode[bvh_node_count]                              (kHasBVH)
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;  // kByteOrderMark 로 써서 endian 이 다르면 알아챈다
+        std::uint32_t flags;
+        std::uint32_t seed;
+        std::uint64_t obstacle_count;
+        std::uint64_t vertex_count;
+        std::uint64_t bvh_node_count;
+        std::int64_t  bvh_root;
+        double world_min, world_max;
+        double start_x, start_y;
+        double goal_x, goal_y;
+        std::uint64_t offsets_pos;
+        std::uint64_t vertices_pos;
+        std::uint64_t bboxes_pos;
+        std::uint64_t bvh_pos;
+        std::uint64_t file_size;
+    };
+
+    struct DiskBVHNode {
+        double min_x, min_y, max_x, max_y;
+        std::int32_t parent, left, right, prim;
+    };
+
+    static_assert(sizeof(FileHeader) == 144, "FileHeader layout");
+    static_assert(sizeof(DiskBVHNode) == 48, "DiskBVHNode layout");
+    static_assert(sizeof(Vec2) == 2 * sizeof(double) && std::is_trivially_copyable<Vec2>::value,
+                  "vertices are copied as raw (x, y) pairs");
+
+    constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+    constexpr std::uint32_t kHasBBoxes = 1u << 0;
+    constexpr std::uint32_t kHasBVH    = 1u << 1;
+
+    std::uint64_t align8(std::uint64_t pos) { return (pos + 7) & ~std::uint64_t(7); }
+
+    // 읽기 전용 mmap (소멸자에서 unmap)
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &filename) {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("Cannot open env file: " + filename);
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Cannot read env file: " + filename);
+            }
+            size_ = static_cast<std::size_t>(st.st_size);
+            void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED)
+                throw std::runtime_error("Cannot mmap env file: " + filename);
+            data_ = static_cast<const unsigned char *>(p);
+        }
+        ~MappedFile() {
+            if (data_)
+                ::munmap(const_cast<unsigned char *>(data_), size_);
+        }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const unsigned char *data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+    private:
+        const unsigned char *data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    // [pos, pos + count * elem) 가 파일 안에 있는지
+    // (header 값은 믿을 수 없으므로 count * elem 을 곱하지 않고 남은 크기를 elem 으로 나눠 비교한다)
+    void checkSection(const MappedFile &file, std::uint64_t pos, std::uint64_t count,
+                      std::uint64_t elem, const char *what) {
+        if (elem == 0 || pos % 8 != 0 || pos > file.size() || count > (file.size() - pos) / elem)
+            throw std::runtime_error(std::string("Corrupt binary env file: bad ") + what + " section");
+    }
+
+    template <class T>
+    void writeRaw(std::ofstream &ofs, const T *data, std::size_t count) {
+        ofs.write(reinterpret_cast<const char *>(data),
+                  static_cast<std::streamsize>(count * sizeof(T)));
+    }
+
+    void padTo(std::ofstream &ofs, std::uint64_t pos) {
+        static const char zeros[8] = {};
+        std::uint64_t cur = static_cast<std::uint64_t>(ofs.tellp());
+        ofs.write(zeros, static_cast<std::streamsize>(pos - cur));
+    }
+}
+
+bool isBinaryEnvironmentFile(const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    char magic[sizeof(kEnvBinaryMagic)];
+    if (!ifs.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, kEnvBinaryMagic, sizeof(magic)) == 0;
+}
+
+void loadEnvironment(const std::string &filename, Environment &env, unsigned int &seed_out) {
+    if (isBinaryEnvironmentFile(filename))
+        loadEnvironmentBinary(filename, env, seed_out);
+    else
+        loadEnvironmentText(filename, env, seed_out);
+}
+
+void loadEnvironmentText(const std::string &filename, Environment &env, unsigned int &seed_out) {
+    std::ifstream ifs(filename);
+    if (!ifs) {
+        throw std::runtime_error("Cannot open env file: " + filename);
+    }
+
+    // First line: "# seed <value>" (+ optional "world <min> <max>")
+    std::string header;
+    std::getline(ifs, header);
+    std::istringstream hs(header);
+    std::string hash, word;
+    hs >> hash >> word >> seed_out; // "# seed 12345"
+    if (hs >> word && word == "world")
+        hs >> env.world_min >> env.world_max;
+
+    int M;
+    ifs >> M;
+    env.obstacles.clear();
+    for (int i = 0; i < M; ++i) {
+        int k;
+        ifs >> k;
+        std::vector<Vec2> pts(k);
+        for (int j = 0; j < k; ++j) {
+            ifs >> pts[j].x >> pts[j].y;
+        }
+        env.obstacles.emplace_back(pts);
+    }
+
+    ifs >> env.start.x >> env.start.y;
+    ifs >> env.goal.x  >> env.goal.y;
+
+    env.rebuildIndex();
+}
+
+void loadEnvironmentBinary(const std::string &filename, Environment &env, unsigned int &seed_out) {
+    MappedFile file(filename);
+    if (file.size() < sizeof(FileHeader))
+        throw std::runtime_error("Binary env file too small: " + filename);
+
+    FileHeader h;
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (std::memcmp(h.magic, kEnvBinaryMagic, sizeof(h.magic)) != 0)
+        throw std::runtime_error("Not a binary env file: " + filename);
+    if (h.byte_order != kByteOrderMark)
+        throw std::runtime_error("Binary env file has different byte order: " + filename);
+    if (h.version != kEnvBinaryVersion)
+        throw std::runtime_error("Unsupported binary env version " + std::to_string(h.version) +
+                                 ": " + filename);
+    if (h.file_size != file.size())
+        throw std::runtime_error("Truncated binary env file: " + filename);
+
+    const std::uint64_t M = h.obstacle_count;
+    // offsets 는 M + 1 개라 M 이 최댓값이면 0 으로 돌아간다
+    if (M >= file.size() / sizeof(std::uint64_t))
+        throw std::runtime_error("Corrupt binary env file: bad obstacle count");
+    checkSection(file, h.offsets_pos, M + 1, sizeof(std::uint64_t), "offsets");
+    checkSection(file, h.vertices_pos, h.vertex_count, sizeof(Vec2), "vertices");
+    if (h.flags & kHasBBoxes)
+        checkSection(file, h.bboxes_pos, M, 4 * sizeof(double), "bboxes");
+    if (h.flags & kHasBVH)
+        checkSection(file, h.bvh_pos, h.bvh_node_count, sizeof(DiskBVHNode), "bvh");
+
+    // section 들은 8 byte 정렬이므로 mmap 한 주소를 그대로 배열로 본다
+    const auto *offsets  = reinterpret_cast<const std::uint64_t *>(file.data() + h.offsets_pos);
+    const auto *vertices = reinterpret_cast<const Vec2 *>(file.data() + h.vertices_pos);
+
+    seed_out = h.seed;
+    env.world_min = h.world_min;
+    env.world_max = h.world_max;
+    env.start = Vec2(h.start_x, h.start_y);
+    env.goal  = Vec2(h.goal_x, h.goal_y);
+
+    env.obstacles.clear();
+    env.obstacles.reserve(M);
+    for (std::uint64_t i = 0; i < M; ++i) {
+        const std::uint64_t b = offsets[i], e = offsets[i + 1];
+        if (b > e || e > h.vertex_count)
+            throw std::runtime_error("Corrupt binary env file: bad obstacle offsets");
+        // bbox 는 모든 index 의 culling 에 쓰이므로 파일의 bboxes section 을 믿지 않고
+        // vertex 를 복사하면서 같이 계산한다 (section 은 이전 파일과의 호환을 위해 쓰기만 한다)
+        std::vector<Vec2> pts;
+        pts.reserve(e - b);
+        AABB box;
+        for (std::uint64_t v = b; v < e; ++v) {
+            pts.push_back(vertices[v]);
+            box.expand(vertices[v]);
+        }
+        env.obstacles.emplace_back(std::move(pts), box);
+    }
+
+    env.rebuildIndex();
+
+    if ((h.flags & kHasBVH) && h.bvh_node_count > 0) {
+        const auto *disk = reinterpret_cast<const DiskBVHNode *>(file.data() + h.bvh_pos);
+        const std::int64_t n_nodes = static_cast<std::int64_t>(h.bvh_node_count);
+        auto valid = [&](std::int32_t id) { return id >= -1 && id < n_nodes; };
+        if (h.bvh_root < 0 || h.bvh_root >= n_nodes)
+            throw std::runtime_error("Corrupt binary env file: bad bvh root");
+
+        std::vector<BVH::Node> nodes(h.bvh_node_count);
+        for (std::uint64_t i = 0; i < h.bvh_node_count; ++i) {
+            const DiskBVHNode &d = disk[i];
+            // 내부 node 는 자식이 둘 다 있고, leaf 는 둘 다 없이 primitive 를 가진다
+            const bool internal = d.left >= 0 && d.right >= 0;
+            const bool leaf = d.left == -1 && d.right == -1 &&
+                              d.prim >= 0 && static_cast<std::uint64_t>(d.prim) < M;
+            if (!valid(d.parent) || !valid(d.left) || !valid(d.right) || !(internal || leaf))
+                throw std::runtime_error("Corrupt binary env file: bad bvh node");
+            nodes[i].box = AABB(Vec2(d.min_x, d.min_y), Vec2(d.max_x, d.max_y));
+            nodes[i].parent = d.parent;
+            nodes[i].left = d.left;
+            nodes[i].right = d.right;
+            nodes[i].prim = d.prim;
+        }
+
+        // root 에서 tree 로 내려가며 모양을 확인한다 (BVH traversal 은 cycle 이나 공유된 자식을 가정하지 않는다)
+        // - root 의 parent 는 -1, 자식의 parent 는 자기를 가리키는 node
+        // - 어느 node 도, 어느 primitive 의 leaf 도 두 번 나오지 않고, 모든 primitive 가 leaf 에 있다
+        // - node box 는 자식 box 를, leaf box 는 그 obstacle 의 bbox 를 담는다
+        //   (아니면 BVH 모드에서 그 obstacle 이 query 에서 빠진다)
+        if (nodes[h.bvh_root].parent != -1)
+            throw std::runtime_error("Corrupt binary env file: bad bvh root");
+        std::vector<char> seen(nodes.size(), 0);
+        std::vector<char> prim_seen(M, 0);
+        std::vector<int> stack(1, static_cast<int>(h.bvh_root));
+        seen[h.bvh_root] = 1;
+        while (!stack.empty()) {
+            const int id = stack.back();
+            stack.pop_back();
+            const BVH::Node &n = nodes[id];
+            if (n.leaf()) {
+                if (prim_seen[n.prim]++)
+                    throw std::runtime_error("Corrupt binary env file: bvh primitive in two leaves");
+                if (!n.box.contains(env.obstacles[n.prim].bbox))
+                    throw std::runtime_error("Corrupt binary env file: bvh leaf box misses its obstacle");
+                continue;
+            }
+            const int children[2] = {n.left, n.right};
+            for (int c : children) {
+                if (seen[c] || nodes[c].parent != id)
+                    throw std::runtime_error("Corrupt binary env file: bvh is not a tree");
+                if (!n.box.contains(nodes[c].box))
+                    throw std::runtime_error("Corrupt binary env file: bvh box misses a child");
+                seen[c] = 1;
+                stack.push_back(c);
+            }
+        }
+        if (std::find(prim_seen.begin(), prim_seen.end(), 0) != prim_seen.end())
+            throw std::runtime_error("Corrupt binary env file: bvh misses an obstacle");
+
+        BVH bvh;
+        bvh.assign(std::move(nodes), static_cast<int>(h.bvh_root));
+        env.setPrebuiltBVH(std::move(bvh));
+    }
+}
+
+void writeEnvironmentText(std::ostream &os, const Environment &env, unsigned int seed,
+                          bool with_world) {
+    os << "# seed " << seed;
+    // 기본 world (20 x 20) 가 아니면 첫 줄에 world 범위를 남긴다
+    if (with_world) {
+        os << " world " << env.world_min << " " << env.world_max;
+        os.precision(10);  // 큰 world 에서도 좌표가 뭉개지지 않게
+    }
+    os << "\n";
+    os << env.obstacles.size() << "\n";
+
+    for (const auto& obs : env.obstacles) {
+        os << obs.pts.size() << "\n";
+        for (const auto& p : obs.pts)
+            os << p.x << " " << p.y << "\n";
+    }
+
+    os << env.start.x << " " << env.start.y << "\n";
+    os << env.goal.x  << " " << env.goal.y << "\n";
+}
+
+void saveEnvironmentBinary(const std::string &filename, const Environment &env,
+                           unsigned int seed, bool with_index) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs)
+        throw std::runtime_error("Cannot open env file for writing: " + filename);
+
+    const std::uint64_t M = env.obstacles.size();
+    if (M == std::numeric_limits<std::uint64_t>::max())
+        throw std::runtime_error("Too many obstacles for binary env file: " + filename);
+    std::vector<std::uint64_t> offsets(M + 1, 0);
+    for (std::uint64_t i = 0; i < M; ++i)
+        offsets[i + 1] = offsets[i] + env.obstacles[i].pts.size();
+
+    std::vector<DiskBVHNode> disk;
+    std::int64_t bvh_root = -1;
+    if (with_index && M > 0) {
+        BVH bvh = env.buildObstacleBVH();
+        bvh_root = bvh.root();
+        disk.reserve(bvh.nodes().size());
+        for (const auto &n : bvh.nodes())
+            disk.push_back({n.box.min.x, n.box.min.y, n.box.max.x, n.box.max.y,
+                            n.parent, n.left, n.right, n.prim});
+    }
+
+    FileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kEnvBinaryMagic, sizeof(h.magic));
+    h.version = kEnvBinaryVersion;
+    h.byte_order = kByteOrderMark;
+    h.flags = kHasBBoxes | (disk.empty() ? 0u : kHasBVH);
+    h.seed = seed;
+    h.obstacle_count = M;
+    h.vertex_count = offsets[M];
+    h.bvh_node_count = disk.size();
+    h.bvh_root = bvh_root;
+    h.world_min = env.world_min;
+    h.world_max = env.world_max;
+    h.start_x = env.start.x;
+    h.start_y = env.start.y;
+    h.goal_x = env.goal.x;
+    h.goal_y = env.goal.y;
+    h.offsets_pos  = align8(sizeof(FileHeader));
+    h.vertices_pos = align8(h.offsets_pos + (M + 1) * sizeof(std::uint64_t));
+    h.bboxes_pos   = align8(h.vertices_pos + h.vertex_count * sizeof(Vec2));
+    h.bvh_pos      = align8(h.bboxes_pos + M * 4 * sizeof(double));
+    h.file_size    = h.bvh_pos + disk.size() * sizeof(DiskBVHNode);
+
+    writeRaw(ofs, &h, 1);
+    padTo(ofs, h.offsets_pos);
+    writeRaw(ofs, offsets.data(), offsets.size());
+    padTo(ofs, h.vertices_pos);
+    for (const auto &obs : env.obstacles)
+        writeRaw(ofs, obs.pts.data(), obs.pts.size());
+    padTo(ofs, h.bboxes_pos);
+    for (const auto &obs : env.obstacles) {
+        const double bb[4] = {obs.bbox.min.x, obs.bbox.min.y, obs.bbox.max.x, obs.bbox.max.y};
+        writeRaw(ofs, bb, 4);
+    }
+    padTo(ofs, h.bvh_pos);
+    writeRaw(ofs, disk.data(), disk.size());
+
+    if (!ofs)
+        throw std::runtime_error("Failed while writing env file: " + filename);
+}
@@ -0,0 +1,32 @@
+// /src/env/env_file.h
+#pragma once
+#include <ostream>
+#include <string>
+#include "environment.h"
+
+// 환경 파일 입출력
+// - text  : env.txt (build_env 기본 출력, "# seed <s> [world <min> <max>]" header)
+// - binary: 고정 header + flat vertex 배열 + obstacle 별 offset (+ bbox, obstacle BVH)
+//           mmap 으로 읽고 vertex 를 하나씩 parse 하지 않는다
+
+// binary 파일 앞 8 byte
+constexpr char kEnvBinaryMagic[8] = {'P', 'L', 'N', 'E', 'N', 'V', '\0', '\0'};
+constexpr unsigned kEnvBinaryVersion = 1;
+
+// 파일 앞부분을 보고 binary 형식인지 판단
+bool isBinaryEnvironmentFile(const std::string &filename);
+
+// 형식을 자동으로 판단해서 읽는다 (seed_out 에 header 의 seed)
+void loadEnvironment(const std::string &filename, Environment &env, unsigned int &seed_out);
+
+void loadEnvironmentText(const std::string &filename, Environment &env, unsigned int &seed_out);
+void loadEnvironmentBinary(const std::string &filename, Environment &env, unsigned int &seed_out);
+
+// env.txt 형식으로 쓴다 (with_world 면 header 에 world 범위, 좌표는 10 자리)
+void writeEnvironmentText(std::ostream &os, const Environment &env, unsigned int seed,
+                          bool with_world);
+
+// binary 형식으로 쓴다 (좌표는 double 그대로)
+// with_index 면 obstacle BVH 도 저장해서 BVH 모드로 읽을 때 다시 만들지 않는다
+void saveEnvironmentBinary(const std::string &filename, const Environment &env,
+                           unsigned int seed, bool with_index = true);
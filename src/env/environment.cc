@@ -1,13 +1,109 @@
 // /home/changmin/PyProject/planning-example/src/env/environment.cc
 #include "environment.h"
+#include "collision_stats.h"
+#include "inflate.h"
+#include "parallel.h"
 #include "rng.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
 namespace {
     constexpr double PI = 3.14159265358979323846;
 
+    // BVH box 를 키우는 margin: box-선분 clipping 의 부동소수점 반올림 때문에
+    // box 경계에 닿는 선분/점이 걸러지지 않게 한다
+    constexpr double kBVHMargin = 1e-6;
+    // 이보다 vertex 가 많은 obstacle 은 edge 단위 BVH 를 따로 만든다
+    constexpr std::size_t kEdgeBVHMinVertices = 32;
+    // 이보다 vertex 가 적은 obstacle 은 ray casting 이 더 빠르다
+    constexpr std::size_t kSlabMinVertices = 16;
+    // CONSERVATIVE 모드에서 clearance field 를 따로 지정하지 않았을 때 world 한 변의 cell 수
+    constexpr int kDefaultClearanceCells = 256;
+    // changesSince 로 돌려줄 수 있는 최근 변경 개수
+    constexpr std::size_t kMaxChangeLog = 1024;
+    // robot radius 로 부풀릴 때 볼록 vertex 원호 한 조각의 최대 각도 (외접 근사, 반지름 2% 이내)
+    constexpr double kInflateArcStep = PI / 8.0;
+
+    // 두 polygon 이 겹치는지 (edge 교차 또는 서로의 vertex 포함)
+    bool polygonsOverlap(const Obstacle &poly, const Obstacle &existing) {
+        // 1) 후보 폴리곤의 edge가 기존 obstacle의 edge와 교차하는지
+        int n = static_cast<int>(poly.pts.size());
+        for (int i = 0; i < n; ++i) {
+            if (existing.intersectsSegment(poly.pts[i], poly.pts[(i + 1) % n]))
+                return true;
+        }
+        // 2) 후보 폴리곤의 vertex가 기존 obstacle 내부에 있는지
+        for (const auto &p : poly.pts) {
+            if (existing.contains(p))
+                return true;
+        }
+        // 3) 기존 obstacle의 vertex가 후보 폴리곤 내부에 있는지
+        for (const auto &p : existing.pts) {
+            if (poly.contains(p))
+                return true;
+        }
+        return false;
+    }
+
+    // generateLarge 의 겹침 검사용 uniform grid (cell 마다 bbox 가 걸치는 obstacle index)
+    class PlacementGrid {
+    public:
+        PlacementGrid(double lo, double hi, double cell)
+            : lo_(lo) {
+            n_ = std::max(1, std::min(kMaxCells, static_cast<int>(std::ceil((hi - lo) / cell))));
+            cell_ = (hi - lo) / n_;
+            if (cell_ <= 0.0) cell_ = 1.0;
+            cells_.resize(static_cast<std::size_t>(n_) * n_);
+        }
+
+        void insert(int id, const AABB &box) {
+            forCells(box, [&](std::vector<int> &c) { c.push_back(id); });
+        }
+
+        // box 와 겹치는 cell 들의 obstacle 을 중복 없이 visit (true 면 중단)
+        template <class Visit>
+        bool anyNear(const AABB &box, Visit &&visit) {
+            ++stamp_;
+            bool hit = false;
+            forCells(box, [&](std::vector<int> &c) {
+                for (int id : c) {
+                    if (hit) return;
+                    if (id >= static_cast<int>(seen_.size()))
+                        seen_.resize(id + 1, 0);
+                    if (seen_[id] == stamp_) continue;
+                    seen_[id] = stamp_;
+                    if (visit(id)) hit = true;
+                }
+            });
+            return hit;
+        }
+
+    private:
+        static constexpr int kMaxCells = 1024;  // 한 변의 최대 cell 수
+
+        int clamp(double v) const {
+            int i = static_cast<int>(std::floor((v - lo_) / cell_));
+            return std::max(0, std::min(i, n_ - 1));
+        }
+
+        template <class Fn>
+        void forCells(const AABB &box, Fn &&fn) {
+            for (int iy = clamp(box.min.y); iy <= clamp(box.max.y); ++iy)
+                for (int ix = clamp(box.min.x); ix <= clamp(box.max.x); ++ix)
+                    fn(cells_[static_cast<std::size_t>(iy) * n_ + ix]);
+        }
+
+        double lo_;
+        double cell_ = 1.0;
+        int n_ = 1;
+        std::vector<std::vector<int>> cells_;
+        std::vector<unsigned> seen_;
+        unsigned stamp_ = 0;
+    };
+
     double polygonArea(const Obstacle& obs) {
         const auto& v = obs.pts;
         int n = static_cast<int>(v.size());
@@ -18,9 +114,38 @@ namespace {
         }
         return 0.5 * std::fabs(area);
     }
+
+    // batch 의 n 개 중 mask word w 에 해당하는 lane 들
+    std::uint64_t wordLanes(std::size_t n, std::size_t w) {
+        const std::size_t left = n - w * 64;
+        return left >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << left) - 1;
+    }
+}
+
+CollisionMode collisionModeFromString(const std::string &name) {
+    if (name == "brute")
+        return CollisionMode::BRUTE_FORCE;
+    if (name == "grid")
+        return CollisionMode::GRID;
+    if (name == "bvh")
+        return CollisionMode::BVH;
+    if (name == "simd")
+        return CollisionMode::SIMD;
+    if (name == "conservative")
+        return CollisionMode::CONSERVATIVE;
+    throw std::runtime_error("Unknown collision mode: " + name);
 }
 
-Obstacle Environment::createRandomPolygon(int vertex_count, double cx, double cy) {
+SizeDistribution sizeDistributionFromString(const std::string &name) {
+    if (name == "uniform")
+        return SizeDistribution::UNIFORM;
+    if (name == "loguniform")
+        return SizeDistribution::LOG_UNIFORM;
+    throw std::runtime_error("Unknown size distribution: " + name);
+}
+
+Obstacle Environment::createRandomPolygon(int vertex_count, double cx, double cy,
+                                          double r_min, double r_max) {
     std::vector<double> angles(vertex_count);
     for (int i = 0; i < vertex_count; ++i)
         angles[i] = RNG::uniform(0.0, 2.0 * PI);
@@ -29,10 +154,7 @@ Obstacle Environment::createRandomPolygon(int vertex_count, double cx, double cy
     std::vector<Vec2> pts;
     pts.reserve(vertex_count);
 
-    // radius 범위를 적당히 잡음 (area 제약은 나중에 필터링)
-    double r_min = 0.7;
-    double r_max = 2.5;
-
+    // radius 범위 안에서 (area 제약은 나중에 필터링)
     for (int i = 0; i < vertex_count; ++i) {
         double r = RNG::uniform(r_min, r_max);
         double x = cx + r * std::cos(angles[i]);
@@ -50,7 +172,10 @@ void Environment::generateRandom(int M_input) {
         std::cerr << "[Environment] Requested " << M_input
                   << " obstacles, clamped to 20.\n";
     }
-    if (M == 0) return;
+    if (M == 0) {
+        rebuildIndex();
+        return;
+    }
 
     int global_attempts = 0;
     const int MAX_GLOBAL_ATTEMPTS = M * 200;
@@ -93,35 +218,10 @@ void Environment::generateRandom(int M_input) {
             // ───────────── 새로 추가: 다른 obstacle들과 겹치지 않게 ─────────────
             bool overlap = false;
             for (const auto &existing : obstacles) {
-                // 1) 후보 폴리곤의 edge가 기존 obstacle의 edge와 교차하는지
-                int n = static_cast<int>(poly.pts.size());
-                for (int i = 0; i < n && !overlap; ++i) {
-                    const Vec2 &a = poly.pts[i];
-                    const Vec2 &b = poly.pts[(i + 1) % n];
-                    if (existing.intersectsSegment(a, b)) {
-                        overlap = true;
-                        break;
-                    }
-                }
-                if (overlap) break;
-
-                // 2) 후보 폴리곤의 vertex가 기존 obstacle 내부에 있는지
-                for (const auto &p : poly.pts) {
-                    if (existing.contains(p)) {
-                        overlap = true;
-                        break;
-                    }
-                }
-                if (overlap) break;
-
-                // 3) 기존 obstacle의 vertex가 후보 폴리곤 내부에 있는지
-                for (const auto &p : existing.pts) {
-                    if (poly.contains(p)) {
-                        overlap = true;
-                        break;
-                    }
+                if (polygonsOverlap(poly, existing)) {
+                    overlap = true;
+                    break;
                 }
-                if (overlap) break;
             }
             if (overlap)
                 continue;
@@ -136,12 +236,345 @@ void Environment::generateRandom(int M_input) {
                   << " obstacles, but only generated "
                   << obstacles.size() << ".\n";
     }
+
+    rebuildIndex();
 }
 
-bool Environment::isFree(const Vec2& p) const {
-    if (p.x < world_min || p.x > world_max ||
-        p.y < world_min || p.y > world_max)
+void Environment::generateLarge(const LargeEnvParams &params) {
+    obstacles.clear();
+    world_min = params.world_min;
+    world_max = params.world_max;
+    start = Vec2(world_min + 0.5, world_min + 0.5);
+    goal  = Vec2(world_max - 0.5, world_max - 0.5);
+
+    const double size_min = std::max(1e-3, std::min(params.size_min, params.size_max));
+    const double size_max = std::max(size_min, params.size_max);
+    const int v_min = std::max(3, std::min(params.vertices_min, params.vertices_max));
+    const int v_max = std::max(v_min, params.vertices_max);
+    const double world_area = (world_max - world_min) * (world_max - world_min);
+    const double target_area = std::max(0.0, params.density) * world_area;
+    const int M = std::max(0, params.max_obstacles);
+
+    // obstacle bbox 는 2 * size_max 이하이므로 cell 하나 크기로 잡으면 주변 cell 몇 개만 보면 된다
+    PlacementGrid placed(world_min, world_max, 2.0 * size_max);
+
+    double area_sum = 0.0;
+    long long attempts = 0;
+    const long long max_attempts = static_cast<long long>(M) * 50;
+    const double margin = 0.1;
+
+    while (static_cast<int>(obstacles.size()) < M && area_sum < target_area &&
+           attempts < max_attempts) {
+        ++attempts;
+
+        double r;
+        if (params.size_dist == SizeDistribution::LOG_UNIFORM)
+            r = std::exp(RNG::uniform(std::log(size_min), std::log(size_max)));
+        else
+            r = RNG::uniform(size_min, size_max);
+        if (world_min + margin + r >= world_max - margin - r)
+            continue;  // world 에 들어가지 않는 크기
+
+        double cx = RNG::uniform(world_min + margin + r, world_max - margin - r);
+        double cy = RNG::uniform(world_min + margin + r, world_max - margin - r);
+        int vertex_count = RNG::uniformInt(v_min, v_max);
+
+        Obstacle poly = createRandomPolygon(vertex_count, cx, cy, 0.5 * r, r);
+
+        // 너무 얇은 polygon 은 버린다 (반지름 r 인 정사각형 면적의 1/4 미만)
+        double area = polygonArea(poly);
+        if (area < 0.5 * r * r)
+            continue;
+        if (poly.contains(start) || poly.contains(goal))
+            continue;
+
+        const AABB box = poly.bbox.inflated(1e-9);
+        bool overlap = placed.anyNear(box, [&](int id) {
+            const Obstacle &existing = obstacles[id];
+            return existing.bbox.overlaps(box) && polygonsOverlap(poly, existing);
+        });
+        if (overlap)
+            continue;
+
+        placed.insert(static_cast<int>(obstacles.size()), box);
+        obstacles.push_back(std::move(poly));
+        area_sum += area;
+    }
+
+    if (static_cast<int>(obstacles.size()) < M && area_sum < target_area) {
+        std::cerr << "[Environment] Warning: stopped after " << attempts
+                  << " attempts with " << obstacles.size() << " obstacles (density "
+                  << area_sum / world_area << ").\n";
+    }
+
+    rebuildIndex();
+}
+
+void Environment::setCollisionMode(CollisionMode mode) {
+    mode_ = mode;
+    rebuildStructures();
+}
+
+void Environment::setOccupancyRaster(double cell_size) {
+    raster_cell_ = cell_size;
+    raster_.clear();
+    if (raster_cell_ > 0.0)
+        raster_.build(obstacles, worldBox(), raster_cell_);
+}
+
+void Environment::setClearanceField(double cell_size, int threads) {
+    clearance_cell_ = cell_size;
+    clearance_threads_ = threads;
+    clearance_.clear();
+    if (clearance_cell_ > 0.0)
+        clearance_.build(obstacles, worldBox(), clearance_cell_, clearance_threads_);
+}
+
+double Environment::clearance(const Vec2 &p) const {
+    if (clearance_.built())
+        return clearance_.clearance(p);
+
+    double best = std::numeric_limits<double>::infinity();
+    for (const auto &obs : obstacles) {
+        int n = static_cast<int>(obs.pts.size());
+        for (int i = 0; i < n; ++i)
+            best = std::min(best, pointSegmentDistance(p, Segment(obs.pts[i], obs.pts[(i + 1) % n])));
+    }
+    return best;
+}
+
+double Environment::clearanceLowerBound(const Vec2 &p) const {
+    if (clearance_.built())
+        return clearance_.lowerBound(p);
+    return clearance(p);
+}
+
+void Environment::setRobotRadius(double radius) {
+    radius = std::max(0.0, radius);
+    if (robot_radius_ > 0.0)
+        obstacles = std::move(raw_obstacles_);
+    raw_obstacles_.clear();
+    robot_radius_ = radius;
+
+    if (robot_radius_ > 0.0) {
+        raw_obstacles_ = obstacles;
+        for (std::size_t i = 0; i < obstacles.size(); ++i)
+            obstacles[i] = inflatePolygon(raw_obstacles_[i], robot_radius_, kInflateArcStep);
+    }
+    rebuildIndex();
+
+    if (robot_radius_ > 0.0 && (!isFree(start) || !isFree(goal))) {
+        std::cerr << "[Environment] Warning: start or goal is not free for robot radius "
+                  << robot_radius_ << ".\n";
+    }
+}
+
+void Environment::setSlabLocators(bool enable) {
+    slab_locators_ = enable;
+    for (auto &obs : obstacles) {
+        if (slab_locators_ && obs.pts.size() >= kSlabMinVertices)
+            obs.buildLocator();
+        else
+            obs.clearLocator();
+    }
+}
+
+void Environment::setPrebuiltBVH(BVH bvh) {
+    prebuilt_bvh_ = std::move(bvh);
+    prebuilt_version_ = version_;
+}
+
+void Environment::rebuildIndex() {
+    // obstacle 이 어떻게 바뀌었는지 모르므로 기록을 비운다
+    ++version_;
+    log_base_ = version_;
+    changes_.clear();
+    rebuildStructures();
+}
+
+void Environment::rebuildStructures() {
+    setSlabLocators(slab_locators_);
+
+    if (mode_ == CollisionMode::CONSERVATIVE && clearance_cell_ <= 0.0)
+        clearance_cell_ = (world_max - world_min) / kDefaultClearanceCells;
+
+    setOccupancyRaster(raster_cell_);
+    setClearanceField(clearance_cell_, clearance_threads_);
+
+    grid_.clear();
+    bvh_.clear();
+    edge_bvh_.clear();
+    edges_.clear();
+
+    if (mode_ == CollisionMode::SIMD || mode_ == CollisionMode::BVH)
+        edges_.build(obstacles);
+
+    // world 전체를 덮어두면 나중에 추가되는 obstacle 도 grid 를 다시 만들 필요가 없다
+    if (mode_ == CollisionMode::GRID)
+        grid_.build(obstacles, worldBox());
+
+    if (mode_ == CollisionMode::BVH) {
+        edge_bvh_.reserve(obstacles.size());
+        for (const auto &obs : obstacles)
+            edge_bvh_.push_back(buildEdgeBVH(obs));
+
+        if (!prebuilt_bvh_.empty() && prebuilt_version_ == version_)
+            bvh_ = prebuilt_bvh_;
+        else
+            bvh_ = buildObstacleBVH();
+    }
+}
+
+BVH Environment::buildObstacleBVH() const {
+    std::vector<AABB> boxes;
+    boxes.reserve(obstacles.size());
+    for (const auto &obs : obstacles)
+        boxes.push_back(obs.bbox.inflated(kBVHMargin));
+    BVH tree;
+    tree.build(boxes);
+    return tree;
+}
+
+BVH Environment::buildEdgeBVH(const Obstacle &obs) const {
+    BVH tree;
+    const std::size_t n = obs.pts.size();
+    if (n < kEdgeBVHMinVertices)
+        return tree;
+    std::vector<AABB> edge_boxes(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        edge_boxes[i].expand(obs.pts[i]);
+        edge_boxes[i].expand(obs.pts[(i + 1) % n]);
+        edge_boxes[i] = edge_boxes[i].inflated(kBVHMargin);
+    }
+    tree.build(edge_boxes);
+    return tree;
+}
+
+void Environment::recordChange(const AABB &region) {
+    ++version_;
+    changes_.push_back({version_, region});
+    if (changes_.size() > kMaxChangeLog) {
+        log_base_ = changes_.front().version;
+        changes_.pop_front();
+    }
+}
+
+bool Environment::changesSince(std::uint64_t since, std::vector<AABB> &regions) const {
+    regions.clear();
+    if (since < log_base_)
         return false;
+    // version 순으로 쌓여 있으므로 since 다음부터
+    auto it = std::upper_bound(changes_.begin(), changes_.end(), since,
+                               [](std::uint64_t v, const Change &c) { return v < c.version; });
+    for (; it != changes_.end(); ++it)
+        regions.push_back(it->region);
+    return true;
+}
+
+int Environment::addObstacle(const Obstacle &obs) {
+    const int oi = static_cast<int>(obstacles.size());
+    if (robot_radius_ > 0.0) {
+        raw_obstacles_.push_back(obs);
+        obstacles.push_back(inflatePolygon(obs, robot_radius_, kInflateArcStep));
+    } else {
+        obstacles.push_back(obs);
+    }
+    Obstacle &added = obstacles.back();
+    added.updateBounds();
+    if (slab_locators_ && added.pts.size() >= kSlabMinVertices)
+        added.buildLocator();
+    else
+        added.clearLocator();
+
+    if (grid_.built() && !grid_.insertObstacle(obstacles, oi))
+        grid_.build(obstacles, worldBox());  // world 밖으로 나간 obstacle
+
+    if (mode_ == CollisionMode::BVH) {
+        bvh_.insert(oi, added.bbox.inflated(kBVHMargin));
+        edge_bvh_.push_back(buildEdgeBVH(added));
+    }
+    if (mode_ == CollisionMode::SIMD || mode_ == CollisionMode::BVH)
+        edges_.append(added);
+
+    raster_.update(obstacles, added.bbox);
+    // EDT 는 전역 연산이라 field 는 통째로 다시 만든다
+    if (clearance_.built())
+        clearance_.build(obstacles, worldBox(), clearance_cell_, clearance_threads_);
+
+    recordChange(added.bbox);
+    return oi;
+}
+
+void Environment::removeObstacle(int index) {
+    if (index < 0 || index >= static_cast<int>(obstacles.size()))
+        throw std::out_of_range("removeObstacle: index " + std::to_string(index) +
+                                " out of range");
+    const int last = static_cast<int>(obstacles.size()) - 1;
+    const AABB region = obstacles[index].bbox;
+
+    if (grid_.built()) {
+        grid_.removeObstacle(obstacles[index], index);
+        if (index != last)
+            grid_.relabelObstacle(obstacles[last], last, index);
+    }
+    if (mode_ == CollisionMode::BVH) {
+        bvh_.remove(index);
+        if (index != last) {
+            bvh_.relabel(last, index);
+            edge_bvh_[index] = std::move(edge_bvh_[last]);
+        }
+        edge_bvh_.pop_back();
+    }
+
+    if (index != last)
+        obstacles[index] = std::move(obstacles[last]);
+    obstacles.pop_back();
+    if (robot_radius_ > 0.0) {
+        if (index != last)
+            raw_obstacles_[index] = std::move(raw_obstacles_[last]);
+        raw_obstacles_.pop_back();
+    }
+
+    // SoA buffer 는 obstacle 순서대로 연속이어야 하므로 다시 채운다 (선형 복사)
+    if (mode_ == CollisionMode::SIMD || mode_ == CollisionMode::BVH)
+        edges_.build(obstacles);
+
+    raster_.update(obstacles, region);
+    if (clearance_.built())
+        clearance_.build(obstacles, worldBox(), clearance_cell_, clearance_threads_);
+
+    recordChange(region);
+}
+
+int Environment::isFreeQuick(const Vec2 &p) const {
+    if (p.x < world_min + robot_radius_ || p.x > world_max - robot_radius_ ||
+        p.y < world_min + robot_radius_ || p.y > world_max - robot_radius_)
+        return 0;
+
+    if (raster_.built()) {
+        OccupancyRaster::State st = raster_.state(p);
+        if (st == OccupancyRaster::FREE)
+            return 1;
+        if (st == OccupancyRaster::OCCUPIED)
+            return 0;
+    }
+    return -1;
+}
+
+bool Environment::isFree(const Vec2& p) const {
+    CollisionProbeScope probe(CollisionProbe::IS_FREE);
+    const int quick = isFreeQuick(p);
+    if (quick >= 0)
+        return quick == 1;
+
+    if (mode_ == CollisionMode::GRID)
+        return !grid_.pointInside(obstacles, p);
+
+    if (mode_ == CollisionMode::BVH) {
+        return !bvh_.queryPoint(p, [&](int oi) {
+            return obstacles[oi].contains(p);
+        });
+    }
 
     for (const auto& obs : obstacles) {
         if (obs.contains(p))
@@ -150,10 +583,226 @@ bool Environment::isFree(const Vec2& p) const {
     return true;
 }
 
+void Environment::setSegmentCache(std::size_t capacity, double quantum) {
+    seg_cache_.configure(capacity, quantum);
+}
+
 bool Environment::segmentFree(const Vec2& a, const Vec2& b) const {
+    CollisionProbeScope probe(CollisionProbe::SEGMENT_FREE);
+    if (!seg_cache_.enabled())
+        return segmentFreeUncached(a, b);
+
+    bool free;
+    if (seg_cache_.lookup(a, b, version_, free))
+        return free;
+    free = segmentFreeUncached(a, b);
+    seg_cache_.insert(a, b, version_, free);
+    return free;
+}
+
+bool Environment::segmentFreeUncached(const Vec2& a, const Vec2& b, SegmentContact contact) const {
+    if (mode_ == CollisionMode::GRID)
+        return !grid_.segmentHits(obstacles, a, b, contact);
+
+    if (mode_ == CollisionMode::BVH) {
+        // obstacle bbox 로 먼저 걸러내고, 큰 polygon 은 edge BVH 로 한 번 더 거른다
+        return !bvh_.querySegment(a, b, [&](int oi) {
+            return obstacleHitsSegment(oi, a, b, contact);
+        });
+    }
+
+    if (mode_ == CollisionMode::SIMD)
+        return !edges_.anyIntersects(a, b, 0, edges_.size(), contact);
+
+    if (mode_ == CollisionMode::CONSERVATIVE && clearance_.built())
+        return segmentFreeConservative(a, b, contact);
+
     for (const auto& obs : obstacles) {
-        if (obs.intersectsSegment(a, b))
+        if (obs.intersectsSegment(a, b, contact))
             return false;
     }
     return true;
 }
+
+bool Environment::obstacleHitsSegment(int oi, const Vec2 &a, const Vec2 &b,
+                                      SegmentContact contact) const {
+    const Obstacle &obs = obstacles[oi];
+    const BVH &edges = edge_bvh_[oi];
+    if (edges.empty())
+        return edges_.anyIntersects(a, b, edges_.obstacleBegin(oi), edges_.obstacleEnd(oi), contact);
+    return edges.querySegment(a, b, [&](int ei) {
+        return obs.edgeIntersectsSegment(ei, a, b, contact);
+    });
+}
+
+bool Environment::segmentFreeConservative(const Vec2 &a, const Vec2 &b,
+                                          SegmentContact contact) const {
+    const double h = clearance_.cellSize();
+    const double threshold = (ca_threshold_ > 0.0) ? ca_threshold_ : 2.0 * h;
+    // 가까운 구간에서 한 번에 exact 검사하는 원의 반지름
+    const double window = std::max(threshold, h);
+
+    auto hitsNear = [&](const Vec2 &center) {
+        return clearance_.forEachEdgeNear(center, window, [&](const ClearanceField::Edge &e) {
+            return obstacles[e.obs].edgeIntersectsSegment(e.edge, a, b, contact);
+        });
+    };
+
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double len = std::sqrt(dx * dx + dy * dy);
+    if (len == 0.0)
+        return !hitsNear(a);
+
+    // 매 step 에서 p 중심 원 안의 선분 구간은 edge 와 만나지 않음이 보장된다
+    // (lower bound 만큼 건너뛰거나, window 안의 edge 를 전부 exact 검사)
+    double t = 0.0;
+    while (true) {
+        Vec2 p(a.x + t * dx, a.y + t * dy);
+        double step = clearance_.lowerBound(p);
+        if (step <= threshold) {
+            if (hitsNear(p))
+                return false;
+            step = window;
+        }
+        t += step / len;
+        if (t >= 1.0)
+            return true;
+    }
+}
+
+std::uint64_t Environment::isFreeWord(const Vec2 *pts, std::uint64_t lanes) const {
+    CollisionProbeScope probe(CollisionProbe::IS_FREE_BATCH);
+    std::uint64_t free = 0;
+    std::uint64_t exact = 0;
+    for (std::uint64_t r = lanes; r; r &= r - 1) {
+        const int l = __builtin_ctzll(r);
+        const int quick = isFreeQuick(pts[l]);
+        if (quick < 0)
+            exact |= std::uint64_t(1) << l;
+        else if (quick == 1)
+            free |= std::uint64_t(1) << l;
+    }
+    if (exact == 0)
+        return free;
+
+    if (mode_ == CollisionMode::BVH) {
+        const std::uint64_t inside = bvh_.queryPacket(
+            exact,
+            [&](const AABB &box, int l) { return box.contains(pts[l]); },
+            [&](int oi, std::uint64_t active) {
+                std::uint64_t hit = 0;
+                for (std::uint64_t r = active; r; r &= r - 1) {
+                    const int l = __builtin_ctzll(r);
+                    if (obstacles[oi].contains(pts[l]))
+                        hit |= std::uint64_t(1) << l;
+                }
+                return hit;
+            });
+        return free | (exact & ~inside);
+    }
+
+    for (std::uint64_t r = exact; r; r &= r - 1) {
+        const int l = __builtin_ctzll(r);
+        const Vec2 &p = pts[l];
+        bool blocked;
+        if (mode_ == CollisionMode::GRID) {
+            blocked = grid_.pointInside(obstacles, p);
+        } else {
+            blocked = false;
+            for (const auto &obs : obstacles) {
+                if (obs.contains(p)) {
+                    blocked = true;
+                    break;
+                }
+            }
+        }
+        if (!blocked)
+            free |= std::uint64_t(1) << l;
+    }
+    return free;
+}
+
+std::uint64_t Environment::segmentFreeWord(const Segment *segs, std::uint64_t lanes,
+                                           SegmentContact contact) const {
+    CollisionProbeScope probe(contact == SegmentContact::BLOCKED ? CollisionProbe::SEGMENT_FREE_BATCH
+                                                                 : CollisionProbe::VISIBILITY_SEGMENT);
+    // cache 는 segmentFree 의 답만 담는다
+    const bool cached = seg_cache_.enabled() && contact == SegmentContact::BLOCKED;
+    std::uint64_t free = 0;
+    std::uint64_t pending = lanes;
+    if (cached) {
+        for (std::uint64_t r = lanes; r; r &= r - 1) {
+            const int l = __builtin_ctzll(r);
+            bool was_free;
+            if (seg_cache_.lookup(segs[l].a, segs[l].b, version_, was_free)) {
+                pending &= ~(std::uint64_t(1) << l);
+                if (was_free)
+                    free |= std::uint64_t(1) << l;
+            }
+        }
+    }
+    if (pending == 0)
+        return free;
+
+    std::uint64_t hit = 0;
+    if (mode_ == CollisionMode::BVH) {
+        // 선분 bbox 와 겹치지 않는 node 는 나눗셈 없이 비교만으로 버린다
+        AABB seg_box[64];
+        for (std::uint64_t r = pending; r; r &= r - 1) {
+            const int l = __builtin_ctzll(r);
+            seg_box[l] = AABB();
+            seg_box[l].expand(segs[l].a);
+            seg_box[l].expand(segs[l].b);
+        }
+        hit = bvh_.queryPacket(
+            pending,
+            [&](const AABB &box, int l) {
+                return box.overlaps(seg_box[l]) && box.overlapsSegment(segs[l].a, segs[l].b);
+            },
+            [&](int oi, std::uint64_t active) {
+                std::uint64_t h = 0;
+                for (std::uint64_t r = active; r; r &= r - 1) {
+                    const int l = __builtin_ctzll(r);
+                    if (obstacleHitsSegment(oi, segs[l].a, segs[l].b, contact))
+                        h |= std::uint64_t(1) << l;
+                }
+                return h;
+            });
+    } else if (mode_ == CollisionMode::SIMD) {
+        hit = edges_.intersectsMany(segs, pending, contact);
+    } else {
+        for (std::uint64_t r = pending; r; r &= r - 1) {
+            const int l = __builtin_ctzll(r);
+            if (!segmentFreeUncached(segs[l].a, segs[l].b, contact))
+                hit |= std::uint64_t(1) << l;
+        }
+    }
+
+    if (cached) {
+        for (std::uint64_t r = pending; r; r &= r - 1) {
+            const int l = __builtin_ctzll(r);
+            seg_cache_.insert(segs[l].a, segs[l].b, version_, !((hit >> l) & 1u));
+        }
+    }
+    return free | (pending & ~hit);
+}
+
+FreeMask Environment::isFreeBatch(const Vec2 *pts, std::size_t n, int threads) const {
+    FreeMask mask(n);
+    std::vector<std::uint64_t> &words = mask.words();
+    parallelFor(0, static_cast<int>(words.size()), [&](int w) {
+        words[w] = isFreeWord(pts + static_cast<std::size_t>(w) * 64, wordLanes(n, w));
+    }, threads, 1);
+    return mask;
+}
+
+FreeMask Environment::segmentFreeBatch(const Segment *segs, std::size_t n, int threads,
+                                       SegmentContact contact) const {
+    FreeMask mask(n);
+    std::vector<std::uint64_t> &words = mask.words();
+    parallelFor(0, static_cast<int>(words.size()), [&](int w) {
+        words[w] = segmentFreeWord(segs + static_cast<std::size_t>(w) * 64, wordLanes(n, w), contact);
+    }, threads, 1);
+    return mask;
+}
@@ -1,7 +1,49 @@
 // /home/changmin/PyProject/planning-example/src/env/environment.h
 #pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
 #include <vector>
+#include "batch.h"
+#include "bvh.h"
+#include "clearance_field.h"
+#include "edge_buffer.h"
+#include "edge_grid.h"
 #include "obstacle.h"
+#include "occupancy_raster.h"
+#include "segment_cache.h"
+
+// isFree / segmentFree 가 사용하는 충돌 검사 방식
+enum class CollisionMode {
+    BRUTE_FORCE,  // 모든 obstacle 을 순회 (reference)
+    GRID,         // uniform grid spatial index
+    BVH,          // obstacle / edge AABB hierarchy
+    SIMD,         // SoA edge buffer 전체를 vector kernel 로 scan
+    CONSERVATIVE  // clearance field 로 conservative advancement, 가까울 때만 exact 검사
+};
+
+CollisionMode collisionModeFromString(const std::string &name);
+
+// generateLarge 에서 obstacle 크기 (외접원 반지름) 를 뽑는 분포
+enum class SizeDistribution {
+    UNIFORM,     // [size_min, size_max] 균등
+    LOG_UNIFORM  // log 균등 (작은 obstacle 이 많음)
+};
+
+SizeDistribution sizeDistributionFromString(const std::string &name);
+
+// 대규모 환경 생성 설정 (world 는 [world_min, world_max]^2 정사각형)
+struct LargeEnvParams {
+    double world_min = 0.0;
+    double world_max = 200.0;
+    int    max_obstacles = 10000;  // 이 개수나 density 중 먼저 도달하는 쪽에서 멈춤
+    double density = 0.3;          // obstacle 면적 합 / world 면적 목표
+    double size_min = 0.7;         // obstacle 반지름 범위
+    double size_max = 2.5;
+    SizeDistribution size_dist = SizeDistribution::UNIFORM;
+    int    vertices_min = 4;
+    int    vertices_max = 8;
+};
 
 class Environment {
 public:
@@ -18,9 +60,152 @@ public:
     // M개의 obstacle을 생성 (M은 1~20으로 clamp)
     void generateRandom(int M);
 
+    // world 크기와 obstacle 수 제한 없이 생성 (겹침 검사는 uniform grid 로 주변만)
+    // world_min/world_max, start/goal 도 params 에 맞게 바뀐다
+    void generateLarge(const LargeEnvParams &params);
+
     bool isFree(const Vec2& p) const;
     bool segmentFree(const Vec2& a, const Vec2& b) const;
 
+    // 여러 개를 한 번에 검사 (결과 bit i = i 번째 항목이 free, isFree / segmentFree 와 같은 답)
+    // - 64개 (mask word 하나) 씩 묶어서 threads 개로 나눠 검사한다 (0 이하면 전체 core)
+    // - BVH 모드는 한 묶음이 obstacle BVH 를 한 번만 내려가고 (packet traversal),
+    //   SIMD 모드는 edge buffer 를 tile 단위로 한 번만 읽으며 묶음의 선분들을 같이 검사한다
+    // - 나머지 모드는 묶음 안에서 항목마다 검사한다
+    // segmentFreeBatch 에 SegmentContact::SHARED_VERTEX 를 주면 선분과 끝점을 공유하는 edge 는 보지 않는다
+    // (visibility graph 처럼 obstacle vertex 끼리 잇는 선분, 같은 index 를 타고 segment cache 는 쓰지 않음)
+    FreeMask isFreeBatch(const Vec2 *pts, std::size_t n, int threads = 1) const;
+    FreeMask isFreeBatch(const std::vector<Vec2> &pts, int threads = 1) const {
+        return isFreeBatch(pts.data(), pts.size(), threads);
+    }
+    FreeMask segmentFreeBatch(const Segment *segs, std::size_t n, int threads = 1,
+                              SegmentContact contact = SegmentContact::BLOCKED) const;
+    FreeMask segmentFreeBatch(const std::vector<Segment> &segs, int threads = 1,
+                              SegmentContact contact = SegmentContact::BLOCKED) const {
+        return segmentFreeBatch(segs.data(), segs.size(), threads, contact);
+    }
+
+    // 충돌 검사 방식을 바꾸고 필요한 index 를 만든다
+    void setCollisionMode(CollisionMode mode);
+    CollisionMode collisionMode() const { return mode_; }
+
+    // isFree 앞단에 occupancy raster 를 둔다 (cell_size <= 0 이면 사용 안 함)
+    // FREE/OCCUPIED cell 은 O(1), edge 가 지나가는 cell 만 exact 검사
+    void setOccupancyRaster(double cell_size);
+    const OccupancyRaster &occupancyRaster() const { return raster_; }
+
+    // 가장 가까운 obstacle edge 까지의 거리 field (cell_size <= 0 이면 사용 안 함)
+    void setClearanceField(double cell_size, int threads = 0);
+    const ClearanceField &clearanceField() const { return clearance_; }
+
+    // p 에서 가장 가까운 obstacle edge 까지의 exact 거리 (field 가 없으면 전체 edge 검사)
+    double clearance(const Vec2 &p) const;
+    // clearance(p) 이하가 보장되는 값 (field 가 있으면 O(1))
+    double clearanceLowerBound(const Vec2 &p) const;
+
+    // CONSERVATIVE 모드: clearance lower bound 가 이 값보다 작아지면 주변 edge 를 exact 검사
+    // (<= 0 이면 clearance field cell 크기의 2배)
+    void setConservativeThreshold(double threshold) { ca_threshold_ = threshold; }
+
+    // segmentFree 앞단에 결과 cache 를 둔다 (capacity == 0 이면 사용 안 함)
+    // quantum > 0 이면 끝점을 그 격자로 양자화해서 key 로 쓴다 (가까운 끝점끼리 "막힘" 결과 공유)
+    // - 근사: 막힌 선분을 free 로 답하지는 않지만, free 인 선분을 막힘으로 답할 수 있다
+    // - 답이 query 순서에 따라 달라지므로 여러 thread 에서 쓰면 결과가 실행마다 다를 수 있다
+    // obstacle 이 바뀌면 (version 이 오르면) 저장된 결과는 전부 무효
+    void setSegmentCache(std::size_t capacity, double quantum = 0.0);
+    const SegmentCache &segmentCache() const { return seg_cache_; }
+
+    // 원판 모양 robot 의 반지름. obstacles 를 Minkowski 합으로 부풀린 polygon 으로 바꿔서
+    // 모든 충돌 검사 (index 포함) 가 추가 비용 없이 robot 중심점만 보면 되게 한다
+    // - 원래 obstacle 은 rawObstacles() 에 남고, 0 을 주면 되돌린다
+    // - world 경계도 radius 만큼 안쪽으로 들어온다 (isFree)
+    // obstacle 을 모두 넣은 (load / generate) 뒤에 부른다
+    void setRobotRadius(double radius);
+    double robotRadius() const { return robot_radius_; }
+    const std::vector<Obstacle> &rawObstacles() const {
+        return robot_radius_ > 0.0 ? raw_obstacles_ : obstacles;
+    }
+
+    // vertex 가 많은 obstacle 들의 contains 를 slab 분할로 답하게 한다
+    void setSlabLocators(bool enable);
+
+    // BVH 모드의 obstacle BVH 를 새로 만들지 않고 이걸 쓰게 한다 (파일에 저장된 index 등)
+    // 지금의 obstacles (version) 기준이어야 하고, obstacle 이 바뀌면 버려진다
+    void setPrebuiltBVH(BVH bvh);
+    // BVH 모드에서 쓰는 obstacle bbox (margin 포함) 위의 BVH 를 새로 만든다
+    BVH buildObstacleBVH() const;
+
+    // obstacles 를 직접 수정한 뒤에는 index 를 다시 만들어야 한다 (version 도 올라감)
+    void rebuildIndex();
+
+    // obstacle 추가 / 삭제. 만들어져 있는 index 들을 점진적으로 갱신하고 version 을 올린다
+    // (robot radius 가 있으면 obs 는 원래 모양으로 주고, 부풀린 것이 obstacles 에 들어간다)
+    // - addObstacle 은 새 obstacle 의 index (= 마지막) 를 반환
+    // - removeObstacle 은 swap-and-pop: 마지막 obstacle 이 index 자리로 옮겨진다
+    int addObstacle(const Obstacle &obs);
+    void removeObstacle(int index);
+
+    // obstacle 이 바뀔 때마다 1씩 증가
+    std::uint64_t version() const { return version_; }
+
+    // since 이후 (since 는 제외) 바뀐 영역들을 regions 에 담는다
+    // 기록이 남아있지 않거나 전체가 다시 만들어진 적이 있으면 false (전체를 무효화해야 함)
+    bool changesSince(std::uint64_t since, std::vector<AABB> &regions) const;
+
 private:
-    Obstacle createRandomPolygon(int vertex_count, double cx, double cy);
+    CollisionMode mode_ = CollisionMode::BRUTE_FORCE;
+    EdgeGrid grid_;
+    BVH bvh_;                    // obstacle bbox 기준
+    std::vector<BVH> edge_bvh_;  // obstacle 별 edge 기준 (vertex 가 많은 것만)
+    BVH prebuilt_bvh_;           // setPrebuiltBVH 로 받은 것 (prebuilt_version_ 에서만 유효)
+    std::uint64_t prebuilt_version_ = 0;
+    EdgeBuffer edges_;           // SoA edge buffer (SIMD, BVH leaf 검사용)
+
+    double raster_cell_ = 0.0;
+    OccupancyRaster raster_;
+
+    double clearance_cell_ = 0.0;
+    int clearance_threads_ = 0;
+    ClearanceField clearance_;
+
+    double ca_threshold_ = 0.0;
+
+    bool slab_locators_ = false;
+
+    mutable SegmentCache seg_cache_;  // segmentFree (const) 가 채운다
+
+    double robot_radius_ = 0.0;
+    std::vector<Obstacle> raw_obstacles_;  // robot_radius_ > 0 일 때 부풀리기 전 obstacle
+
+    // 최근 변경 기록 (version 순). log_base_ 이하의 version 에 대해서는 기록이 없다
+    struct Change {
+        std::uint64_t version;
+        AABB region;
+    };
+    std::uint64_t version_ = 0;
+    std::uint64_t log_base_ = 0;
+    std::deque<Change> changes_;
+
+    AABB worldBox() const { return AABB(Vec2(world_min, world_min), Vec2(world_max, world_max)); }
+
+    bool segmentFreeUncached(const Vec2 &a, const Vec2 &b,
+                             SegmentContact contact = SegmentContact::BLOCKED) const;
+    // BVH 모드에서 bbox 로 걸러진 obstacle oi 의 edge 와 (a,b) 가 교차하는지
+    bool obstacleHitsSegment(int oi, const Vec2 &a, const Vec2 &b,
+                             SegmentContact contact = SegmentContact::BLOCKED) const;
+    // isFree 중 world 경계 / raster 로 답이 나는 부분 (-1 이면 exact 검사가 필요)
+    int isFreeQuick(const Vec2 &p) const;
+    // isFreeBatch / segmentFreeBatch 의 64개 묶음 하나 (lanes 의 bit 가 켜진 것만, 결과는 free bit)
+    std::uint64_t isFreeWord(const Vec2 *pts, std::uint64_t lanes) const;
+    std::uint64_t segmentFreeWord(const Segment *segs, std::uint64_t lanes,
+                                  SegmentContact contact) const;
+    bool segmentFreeConservative(const Vec2 &a, const Vec2 &b, SegmentContact contact) const;
+
+    // obstacle 은 그대로 두고 index 들만 다시 만든다
+    void rebuildStructures();
+    void recordChange(const AABB &region);
+    BVH buildEdgeBVH(const Obstacle &obs) const;
+
+    Obstacle createRandomPolygon(int vertex_count, double cx, double cy,
+                                 double r_min = 0.7, double r_max = 2.5);
 };
@@ -0,0 +1,15 @@
+// /src/env/geometry.cc
+#include "geometry.h"
+
+#define GEOMETRY_INSTANTIATE(T)                                                       \
+    template T cross<T>(const Vec2T<T> &, const Vec2T<T> &, const Vec2T<T> &);        \
+    template int orientation<T>(const Vec2T<T> &, const Vec2T<T> &, const Vec2T<T> &); \
+    template bool onSegment<T>(const Vec2T<T> &, const Vec2T<T> &, const Vec2T<T> &); \
+    template bool segmentsIntersect<T>(const Vec2T<T> &, const Vec2T<T> &,            \
+                                       const Vec2T<T> &, const Vec2T<T> &);           \
+    template bool sharesEndpoint<T>(const Vec2T<T> &, const Vec2T<T> &,               \
+                                    const Vec2T<T> &, const Vec2T<T> &, T);           \
+    template bool pointInPolygon<T>(const Vec2T<T> *, std::size_t, const Vec2T<T> &);
+
+GEOMETRY_INSTANTIATE(float)
+GEOMETRY_INSTANTIATE(double)
@@ -0,0 +1,93 @@
+// /src/env/geometry.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include "predicates.h"
+#include "vec2.h"
+
+// scalar 타입 (float / double) 에 대해 템플릿으로 만든 기본 predicate
+// 부호 판정은 모두 predicates.h 의 exact orient2d (float 좌표는 double 로 올려도 exact)
+// float / double 은 geometry.cc 에서 명시적으로 instantiate
+
+// (b - a) x (c - a)
+template <class T>
+inline T cross(const Vec2T<T> &a, const Vec2T<T> &b, const Vec2T<T> &c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// cross 의 정확한 부호 (정확히 collinear 일 때만 0)
+template <class T>
+inline int orientation(const Vec2T<T> &a, const Vec2T<T> &b, const Vec2T<T> &c) {
+    return orient2d(Vec2(a), Vec2(b), Vec2(c));
+}
+
+// p 가 선분 [a, b] 위에 있는지 (collinear 판정 + bounding box)
+template <class T>
+inline bool onSegment(const Vec2T<T> &a, const Vec2T<T> &b, const Vec2T<T> &p) {
+    if (orientation(a, b, p) != 0) return false;
+    return (p.x >= std::min(a.x, b.x) && p.x <= std::max(a.x, b.x) &&
+            p.y >= std::min(a.y, b.y) && p.y <= std::max(a.y, b.y));
+}
+
+// 닫힌 선분 (p1,p2) 와 (q1,q2) 가 만나는지 (끝점 접촉, collinear 겹침 포함)
+template <class T>
+inline bool segmentsIntersect(const Vec2T<T> &p1, const Vec2T<T> &p2,
+                              const Vec2T<T> &q1, const Vec2T<T> &q2) {
+    int d1 = orientation(p1, p2, q1);
+    int d2 = orientation(p1, p2, q2);
+    int d3 = orientation(q1, q2, p1);
+    int d4 = orientation(q1, q2, p2);
+
+    if (d1 * d2 < 0 && d3 * d4 < 0) return true;
+    if (d1 == 0 && onSegment(p1, p2, q1)) return true;
+    if (d2 == 0 && onSegment(p1, p2, q2)) return true;
+    if (d3 == 0 && onSegment(q1, q2, p1)) return true;
+    if (d4 == 0 && onSegment(q1, q2, p2)) return true;
+
+    return false;
+}
+
+// 선분 (p,q) 의 끝점 중 하나가 (a,b) 의 끝점 중 하나와 eps 안에서 같은지
+template <class T>
+inline bool sharesEndpoint(const Vec2T<T> &p, const Vec2T<T> &q,
+                           const Vec2T<T> &a, const Vec2T<T> &b, T eps = T(1e-8)) {
+    auto near = [eps](const Vec2T<T> &u, const Vec2T<T> &v) {
+        const T dx = u.x - v.x;
+        const T dy = u.y - v.y;
+        return dx * dx + dy * dy < eps * eps;
+    };
+    return near(p, a) || near(p, b) || near(q, a) || near(q, b);
+}
+
+// ray casting point-in-polygon (pts[0..n) 은 닫힌 다각형)
+// 교점 x 를 나눗셈으로 구하는 대신 "p 가 edge 의 왼쪽인가" 를 orientation 으로 판정한다
+// (위로 가는 edge 면 왼쪽, 아래로 가는 edge 면 오른쪽일 때 p.x < 교점 x)
+template <class T>
+inline bool pointInPolygon(const Vec2T<T> *pts, std::size_t n, const Vec2T<T> &p) {
+    bool inside = false;
+    for (std::size_t i = 0, j = n - 1; i < n; j = i++) {
+        const Vec2T<T> &a = pts[j];
+        const Vec2T<T> &b = pts[i];
+        if ((a.y > p.y) == (b.y > p.y))
+            continue;
+        const int o = orientation(a, b, p);
+        if (b.y > a.y ? o > 0 : o < 0)
+            inside = !inside;
+    }
+    return inside;
+}
+
+#define GEOMETRY_DECLARE_INSTANCES(T)                                                        \
+    extern template T cross<T>(const Vec2T<T> &, const Vec2T<T> &, const Vec2T<T> &);        \
+    extern template int orientation<T>(const Vec2T<T> &, const Vec2T<T> &, const Vec2T<T> &); \
+    extern template bool onSegment<T>(const Vec2T<T> &, const Vec2T<T> &, const Vec2T<T> &); \
+    extern template bool segmentsIntersect<T>(const Vec2T<T> &, const Vec2T<T> &,            \
+                                              const Vec2T<T> &, const Vec2T<T> &);           \
+    extern template bool sharesEndpoint<T>(const Vec2T<T> &, const Vec2T<T> &,               \
+                                           const Vec2T<T> &, const Vec2T<T> &, T);           \
+    extern template bool pointInPolygon<T>(const Vec2T<T> *, std::size_t, const Vec2T<T> &);
+
+GEOMETRY_DECLARE_INSTANCES(float)
+GEOMETRY_DECLARE_INSTANCES(double)
+
+#undef GEOMETRY_DECLARE_INSTANCES
@@ -0,0 +1,131 @@
+// /src/env/inflate.cc
+#include "inflate.h"
+#include "geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+    double signedArea(const std::vector<Vec2> &v) {
+        double area = 0.0;
+        const std::size_t n = v.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            const Vec2 &p = v[i];
+            const Vec2 &q = v[(i + 1) % n];
+            area += p.x * q.y - q.x * p.y;
+        }
+        return 0.5 * area;
+    }
+
+    // 이웃하지 않는 edge 끼리 만나지 않으면 단순 다각형
+    bool isSimple(const std::vector<Vec2> &v) {
+        const std::size_t n = v.size();
+        if (n < 3)
+            return false;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 2; j < n; ++j) {
+                if (i == 0 && j == n - 1)
+                    continue;  // 첫 edge 와 마지막 edge 는 이웃
+                if (segmentsIntersect(v[i], v[(i + 1) % n], v[j], v[(j + 1) % n]))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Andrew monotone chain (CCW, collinear 점 제거)
+    std::vector<Vec2> convexHull(std::vector<Vec2> pts) {
+        std::sort(pts.begin(), pts.end(), [](const Vec2 &a, const Vec2 &b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+        const std::size_t n = pts.size();
+        if (n < 3)
+            return pts;
+        std::vector<Vec2> hull(2 * n);
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            while (k >= 2 && orientation(hull[k - 2], hull[k - 1], pts[i]) <= 0)
+                --k;
+            hull[k++] = pts[i];
+        }
+        for (std::size_t i = n - 1, t = k + 1; i > 0; --i) {
+            while (k >= t && orientation(hull[k - 2], hull[k - 1], pts[i - 1]) <= 0)
+                --k;
+            hull[k++] = pts[i - 1];
+        }
+        hull.resize(k - 1);
+        return hull;
+    }
+}
+
+Obstacle inflatePolygon(const Obstacle &obs, double radius, double max_arc_step) {
+    if (radius <= 0.0 || obs.pts.size() < 3)
+        return obs;
+
+    // 길이 0 인 edge 를 없애고 CCW 로 맞춘다
+    std::vector<Vec2> v;
+    v.reserve(obs.pts.size());
+    for (const auto &p : obs.pts) {
+        if (v.empty() || p.x != v.back().x || p.y != v.back().y)
+            v.push_back(p);
+    }
+    while (v.size() > 1 && v.front().x == v.back().x && v.front().y == v.back().y)
+        v.pop_back();
+    if (v.size() < 3)
+        return obs;
+    if (signedArea(v) < 0.0)
+        std::reverse(v.begin(), v.end());
+
+    const std::size_t n = v.size();
+    // edge i (v[i] -> v[i+1]) 의 바깥쪽 단위 법선 (CCW 이므로 오른쪽)
+    std::vector<Vec2> normal(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const Vec2 &a = v[i];
+        const Vec2 &b = v[(i + 1) % n];
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double len = std::sqrt(dx * dx + dy * dy);
+        normal[i] = Vec2(dy / len, -dx / len);
+    }
+
+    const double step = std::max(1e-3, max_arc_step);
+    std::vector<Vec2> out;
+    out.reserve(n * 4);
+    for (std::size_t i = 0; i < n; ++i) {
+        const Vec2 &p = v[i];
+        const Vec2 &n0 = normal[(i + n - 1) % n];  // 들어오는 edge
+        const Vec2 &n1 = normal[i];                // 나가는 edge
+        const double turn = n0.x * n1.y - n0.y * n1.x;  // > 0 이면 볼록 vertex
+        const double dot = n0.x * n1.x + n0.y * n1.y;
+
+        if (turn > 0.0) {
+            // 원호 n0 -> n1 을 외접 다각형으로: 양 끝은 offset edge 위, 가운데 점들은 접선의 교점
+            const double a0 = std::atan2(n0.y, n0.x);
+            const double sweep = std::atan2(turn, dot);  // (0, PI)
+            const int k = std::max(1, static_cast<int>(std::ceil(sweep / step)));
+            const double theta = sweep / k;
+            const double rr = radius / std::cos(0.5 * theta);
+            out.emplace_back(p.x + radius * n0.x, p.y + radius * n0.y);
+            for (int j = 0; j < k; ++j) {
+                const double a = a0 + (j + 0.5) * theta;
+                out.emplace_back(p.x + rr * std::cos(a), p.y + rr * std::sin(a));
+            }
+            out.emplace_back(p.x + radius * n1.x, p.y + radius * n1.y);
+        } else if (dot > 1.0 - 1e-12) {
+            // 일직선
+            out.emplace_back(p.x + radius * n1.x, p.y + radius * n1.y);
+        } else if (dot < -1.0 + 1e-9) {
+            // 안쪽으로 접힌 spike: 교점이 없으므로 두 offset 점 (결과가 꼬이면 아래에서 hull)
+            out.emplace_back(p.x + radius * n0.x, p.y + radius * n0.y);
+            out.emplace_back(p.x + radius * n1.x, p.y + radius * n1.y);
+        } else {
+            // 오목 vertex: 두 offset edge 의 교점
+            const double s = radius / (1.0 + dot);
+            out.emplace_back(p.x + s * (n0.x + n1.x), p.y + s * (n0.y + n1.y));
+        }
+    }
+
+    if (!isSimple(out))
+        out = convexHull(out);
+    return Obstacle(out);
+}
@@ -0,0 +1,10 @@
+// /src/env/inflate.h
+#pragma once
+#include "obstacle.h"
+
+// 반지름 radius 인 원판과의 Minkowski 합을 덮는 polygon
+// - 볼록 vertex 는 원호를 외접 다각형으로 근사 (한 조각의 각도 <= max_arc_step) → 항상 합을 포함
+// - 오목 vertex 는 양쪽 offset edge 의 교점 (exact)
+// - offset 결과가 단순 다각형이 아니면 (radius 보다 좁은 홈 등) offset 점들의 convex hull 로 대신한다
+// 결과는 CCW 순서
+Obstacle inflatePolygon(const Obstacle &obs, double radius, double max_arc_step);
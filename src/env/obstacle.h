@@ -1,28 +1,49 @@
 // /home/changmin/PyProject/planning-example/src/env/obstacle.h
 #pragma once
+#include <memory>
+#include <utility>
 #include <vector>
+#include "aabb.h"
+#include "vec2.h"
 
-struct Vec2 {
-    double x, y;
-    Vec2() : x(0.0), y(0.0) {}
-    Vec2(double x_, double y_) : x(x_), y(y_) {}
+class SlabLocator;
+
+// 선분 검사에서 obstacle 경계와의 접촉을 어떻게 볼지
+enum class SegmentContact {
+    BLOCKED,        // 닿기만 해도 막힘 (segmentFree)
+    SHARED_VERTEX   // 선분과 끝점을 공유하는 edge 는 보지 않음 (visibility graph 의 vertex 끼리 잇는 선분)
 };
 
 class Obstacle {
 public:
     std::vector<Vec2> pts;   // simple polygon (Jordan curve)
+    AABB bbox;               // pts 의 bounding box (updateBounds 로 갱신)
 
     Obstacle() = default;
-    explicit Obstacle(const std::vector<Vec2>& vertices) : pts(vertices) {}
+    explicit Obstacle(const std::vector<Vec2>& vertices) : pts(vertices) { updateBounds(); }
+    // bbox 를 이미 알고 있을 때 (파일에 저장된 bbox 등)
+    Obstacle(std::vector<Vec2> vertices, const AABB &box) : pts(std::move(vertices)), bbox(box) {}
+
+    // pts 를 직접 수정했다면 다시 호출
+    void updateBounds();
+
+    // contains 를 O(log k) 로 답하는 slab 분할을 미리 만들어 둔다 (pts 가 바뀌면 다시 호출)
+    void buildLocator();
+    void clearLocator() { locator_.reset(); }
+    bool hasLocator() const { return static_cast<bool>(locator_); }
 
     // 점이 다각형 내부에 있는지 (edge 위 포함해도 됨)
     bool contains(const Vec2& p) const;
 
     // 선분 (a,b)가 이 다각형의 어떤 edge와도 교차하는지
-    bool intersectsSegment(const Vec2& a, const Vec2& b) const;
+    bool intersectsSegment(const Vec2& a, const Vec2& b,
+                           SegmentContact contact = SegmentContact::BLOCKED) const;
+
+    // 선분 (a,b)가 i번째 edge (pts[i], pts[i+1])와 교차하는지
+    // (spatial index가 후보 edge 하나씩 검사할 때 사용)
+    bool edgeIntersectsSegment(int i, const Vec2& a, const Vec2& b,
+                               SegmentContact contact = SegmentContact::BLOCKED) const;
 
 private:
-    bool onSegment(const Vec2& a, const Vec2& b, const Vec2& p) const;
-    bool segmentsIntersect(const Vec2& p1, const Vec2& p2,
-                           const Vec2& q1, const Vec2& q2) const;
+    std::shared_ptr<const SlabLocator> locator_;  // 불변이므로 복사본끼리 공유
 };
@@ -0,0 +1,135 @@
+// /src/env/occupancy_raster.cc
+#include "occupancy_raster.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // edge 에서 이 거리 안쪽의 cell 은 MIXED 로 둔다 (ray casting 오차보다 충분히 큼)
+    constexpr double kMargin = 1e-6;
+    constexpr std::uint8_t kUnknown = 0xFF;
+}
+
+void OccupancyRaster::clear() {
+    world_ = AABB();
+    cell_ = 0.0;
+    nx_ = ny_ = 0;
+    cells_.clear();
+}
+
+int OccupancyRaster::clampX(double x) const {
+    int i = static_cast<int>(std::floor((x - world_.min.x) / cell_));
+    return std::max(0, std::min(i, nx_ - 1));
+}
+
+int OccupancyRaster::clampY(double y) const {
+    int i = static_cast<int>(std::floor((y - world_.min.y) / cell_));
+    return std::max(0, std::min(i, ny_ - 1));
+}
+
+void OccupancyRaster::build(const std::vector<Obstacle> &obstacles,
+                            const AABB &world, double cell_size) {
+    clear();
+    if (cell_size <= 0.0 || world.empty())
+        return;
+
+    world_ = world;
+    cell_ = cell_size;
+    nx_ = std::max(1, static_cast<int>(std::ceil((world.max.x - world.min.x) / cell_)));
+    ny_ = std::max(1, static_cast<int>(std::ceil((world.max.y - world.min.y) / cell_)));
+    cells_.assign(static_cast<std::size_t>(nx_) * ny_, kUnknown);
+
+    classify(obstacles, 0, nx_ - 1, 0, ny_ - 1);
+}
+
+void OccupancyRaster::update(const std::vector<Obstacle> &obstacles, const AABB &region) {
+    if (!built() || region.empty())
+        return;
+    AABB r = region.inflated(kMargin);
+    if (!r.overlaps(world_))
+        return;
+    classify(obstacles, clampX(r.min.x), clampX(r.max.x), clampY(r.min.y), clampY(r.max.y));
+}
+
+AABB OccupancyRaster::cellBox(int ix, int iy) const {
+    return AABB(Vec2(world_.min.x + ix * cell_, world_.min.y + iy * cell_),
+                Vec2(world_.min.x + (ix + 1) * cell_, world_.min.y + (iy + 1) * cell_));
+}
+
+void OccupancyRaster::classify(const std::vector<Obstacle> &obstacles,
+                               int ix0, int ix1, int iy0, int iy1) {
+    for (int iy = iy0; iy <= iy1; ++iy)
+        for (int ix = ix0; ix <= ix1; ++ix)
+            cells_[cellIndex(ix, iy)] = kUnknown;
+    const AABB range(cellBox(ix0, iy0).min, cellBox(ix1, iy1).max);
+
+    // 1) edge 가 지나가는 cell 은 MIXED
+    for (const auto &obs : obstacles) {
+        if (!obs.bbox.inflated(kMargin).overlaps(range))
+            continue;
+        int n = static_cast<int>(obs.pts.size());
+        for (int i = 0; i < n; ++i) {
+            const Vec2 &a = obs.pts[i];
+            const Vec2 &b = obs.pts[(i + 1) % n];
+            AABB eb;
+            eb.expand(a);
+            eb.expand(b);
+            eb = eb.inflated(kMargin);
+            if (!eb.overlaps(range))
+                continue;
+            int ex0 = std::max(ix0, clampX(eb.min.x)), ex1 = std::min(ix1, clampX(eb.max.x));
+            int ey0 = std::max(iy0, clampY(eb.min.y)), ey1 = std::min(iy1, clampY(eb.max.y));
+            for (int iy = ey0; iy <= ey1; ++iy) {
+                for (int ix = ex0; ix <= ex1; ++ix) {
+                    if (cellBox(ix, iy).inflated(kMargin).overlapsSegment(a, b))
+                        cells_[cellIndex(ix, iy)] = MIXED;
+                }
+            }
+        }
+    }
+
+    // 2) 나머지 cell 들은 edge 로 나뉘지 않은 영역끼리 flood fill 하고,
+    //    영역마다 대표점 하나만 exact 하게 검사한다 (fill 은 범위 안에서만)
+    std::vector<int> queue;
+    for (int sy = iy0; sy <= iy1; ++sy) {
+        for (int sx = ix0; sx <= ix1; ++sx) {
+            const int start = cellIndex(sx, sy);
+            if (cells_[start] != kUnknown)
+                continue;
+
+            Vec2 c(world_.min.x + (sx + 0.5) * cell_, world_.min.y + (sy + 0.5) * cell_);
+            bool inside = false;
+            for (const auto &obs : obstacles) {
+                if (obs.bbox.contains(c) && obs.contains(c)) {
+                    inside = true;
+                    break;
+                }
+            }
+            const std::uint8_t st = inside ? OCCUPIED : FREE;
+
+            queue.clear();
+            queue.push_back(start);
+            cells_[start] = st;
+            while (!queue.empty()) {
+                int cur = queue.back();
+                queue.pop_back();
+                int cx = cur % nx_, cy = cur / nx_;
+                const int nbr[4][2] = {{cx - 1, cy}, {cx + 1, cy}, {cx, cy - 1}, {cx, cy + 1}};
+                for (const auto &nb : nbr) {
+                    if (nb[0] < ix0 || nb[0] > ix1 || nb[1] < iy0 || nb[1] > iy1)
+                        continue;
+                    int ni = cellIndex(nb[0], nb[1]);
+                    if (cells_[ni] != kUnknown)
+                        continue;
+                    cells_[ni] = st;
+                    queue.push_back(ni);
+                }
+            }
+        }
+    }
+}
+
+OccupancyRaster::State OccupancyRaster::state(const Vec2 &p) const {
+    if (!built() || !world_.contains(p))
+        return MIXED;
+    return static_cast<State>(cells_[cellIndex(clampX(p.x), clampY(p.y))]);
+}
@@ -0,0 +1,49 @@
+// /src/env/occupancy_raster.h
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "aabb.h"
+#include "obstacle.h"
+
+// world 영역을 정사각 cell 로 나눈 occupancy bitmap
+// - edge 가 지나가지 않는 cell 은 cell 전체가 FREE 또는 OCCUPIED 이므로 O(1) 로 답한다
+// - edge 가 지나가는 (MIXED) cell 만 exact 검사가 필요하다
+class OccupancyRaster {
+public:
+    enum State : std::uint8_t {
+        FREE = 0,
+        OCCUPIED = 1,
+        MIXED = 2
+    };
+
+    OccupancyRaster() = default;
+
+    void build(const std::vector<Obstacle> &obstacles, const AABB &world, double cell_size);
+    void clear();
+
+    // region 과 겹치는 cell 들만 다시 분류한다 (obstacle 추가/삭제 후)
+    void update(const std::vector<Obstacle> &obstacles, const AABB &region);
+
+    bool built() const { return nx_ > 0; }
+
+    // world 밖의 점은 MIXED (호출하는 쪽에서 exact 검사)
+    State state(const Vec2 &p) const;
+
+    double cellSize() const { return cell_; }
+    int width() const { return nx_; }
+    int height() const { return ny_; }
+
+private:
+    int cellIndex(int ix, int iy) const { return iy * nx_ + ix; }
+    int clampX(double x) const;
+    int clampY(double y) const;
+    AABB cellBox(int ix, int iy) const;
+    // [ix0,ix1] x [iy0,iy1] 범위의 cell 을 분류 (범위 밖 cell 은 건드리지 않음)
+    void classify(const std::vector<Obstacle> &obstacles, int ix0, int ix1, int iy0, int iy1);
+
+    AABB   world_;
+    double cell_ = 0.0;
+    int    nx_ = 0;
+    int    ny_ = 0;
+    std::vector<std::uint8_t> cells_;
+};
@@ -0,0 +1,129 @@
+// /src/env/parallel.h
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 0 이하를 주면 hardware_concurrency 사용
+inline int resolveThreadCount(int threads) {
+    if (threads > 0)
+        return threads;
+    unsigned hc = std::thread::hardware_concurrency();
+    return hc == 0 ? 1 : static_cast<int>(hc);
+}
+
+namespace parallel_detail {
+    // parallelFor 가 쓰는 process 전체의 worker thread pool
+    // - thread 는 처음 필요한 만큼 만들고 계속 재사용한다 (호출마다 만들고 join 하지 않음)
+    // - job 은 한 번에 하나: 여러 thread 에서 동시에 부르면 앞의 job 이 끝날 때까지 기다린다
+    class ThreadPool {
+    public:
+        // 일부러 해제하지 않는다 (exit 때 static 소멸 순서와 얽히지 않도록 worker 는 대기 상태로 남는다)
+        static ThreadPool &instance() {
+            static ThreadPool *pool = new ThreadPool();
+            return *pool;
+        }
+
+        // job 을 pool thread helpers 개와 호출한 thread 에서 같이 실행하고, 모두 끝나면 반환
+        // (job 은 예외를 밖으로 내보내면 안 된다)
+        void run(int helpers, const std::function<void()> &job) {
+            std::lock_guard<std::mutex> serial(run_mutex_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                while (static_cast<int>(threads_.size()) < helpers)
+                    threads_.emplace_back([this] { workerLoop(); });
+                job_ = &job;
+                unclaimed_ = helpers;
+                running_ = helpers;
+            }
+            wake_.notify_all();
+            job();
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return running_ == 0; });
+            job_ = nullptr;
+        }
+
+    private:
+        ThreadPool() = default;
+
+        void workerLoop();
+
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const std::function<void()> *job_ = nullptr;
+        int unclaimed_ = 0;  // 아직 어떤 worker 도 가져가지 않은 자리
+        int running_ = 0;    // 끝나지 않은 자리
+        std::vector<std::thread> threads_;
+    };
+
+    // 현재 thread 가 parallelFor 의 job 을 실행 중인지 (안에서 다시 부르면 그 자리에서 순서대로 실행)
+    inline bool &insideParallelFor() {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    inline void ThreadPool::workerLoop() {
+        insideParallelFor() = true;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return unclaimed_ > 0; });
+            --unclaimed_;
+            const std::function<void()> *job = job_;
+            lock.unlock();
+            (*job)();
+            lock.lock();
+            if (--running_ == 0)
+                done_.notify_one();
+        }
+    }
+}
+
+// [begin, end) 의 각 i 에 대해 fn(i) 를 여러 thread 에서 실행
+// - index 는 chunk 단위로 atomic counter 에서 가져간다 (결과는 index 로만 써야 결정적)
+// - threads == 1 이거나 parallelFor 안에서 다시 부르면 현재 thread 에서 순서대로 실행
+// - fn 이 예외를 던지면 남은 chunk 는 건너뛰고, 모든 thread 가 멈춘 뒤 첫 예외를 호출한 thread 에서 다시 던진다
+template <class Fn>
+void parallelFor(int begin, int end, Fn &&fn, int threads = 0, int chunk = 16) {
+    if (end <= begin)
+        return;
+    int n_threads = std::min(resolveThreadCount(threads), (end - begin + chunk - 1) / chunk);
+    if (n_threads <= 1 || parallel_detail::insideParallelFor()) {
+        for (int i = begin; i < end; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<int> next(begin);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    const std::function<void()> worker = [&]() {
+        try {
+            while (true) {
+                int i0 = next.fetch_add(chunk);
+                if (i0 >= end)
+                    break;
+                int i1 = std::min(end, i0 + chunk);
+                for (int i = i0; i < i1; ++i)
+                    fn(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+            next.store(end);
+        }
+    };
+
+    parallel_detail::insideParallelFor() = true;
+    parallel_detail::ThreadPool::instance().run(n_threads - 1, worker);
+    parallel_detail::insideParallelFor() = false;
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,200 @@
+// /src/env/predicates.cc
+// J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+// Geometric Predicates" 의 orient2d (stage A ~ D) 를 옮긴 것.
+// two-product 등이 정확하려면 곱셈-뺄셈이 FMA 로 합쳐지면 안 된다 (CMake 에서 -ffp-contract=off)
+#include "predicates.h"
+
+namespace {
+    constexpr double kEpsilon = 1.1102230246251565e-16;  // 2^-53
+    constexpr double kSplitter = 134217729.0;            // 2^27 + 1
+    constexpr double kResultErrBound = (3.0 + 8.0 * kEpsilon) * kEpsilon;
+    constexpr double kCcwErrBoundA = (3.0 + 16.0 * kEpsilon) * kEpsilon;
+    constexpr double kCcwErrBoundB = (2.0 + 12.0 * kEpsilon) * kEpsilon;
+    constexpr double kCcwErrBoundC = (9.0 + 64.0 * kEpsilon) * kEpsilon * kEpsilon;
+
+    inline void fastTwoSum(double a, double b, double &x, double &y) {
+        x = a + b;
+        double bv = x - a;
+        y = b - bv;
+    }
+
+    inline void twoSum(double a, double b, double &x, double &y) {
+        x = a + b;
+        double bv = x - a;
+        double av = x - bv;
+        double br = b - bv;
+        double ar = a - av;
+        y = ar + br;
+    }
+
+    inline void twoDiffTail(double a, double b, double x, double &y) {
+        double bv = a - x;
+        double av = x + bv;
+        double br = bv - b;
+        double ar = a - av;
+        y = ar + br;
+    }
+
+    inline void twoDiff(double a, double b, double &x, double &y) {
+        x = a - b;
+        twoDiffTail(a, b, x, y);
+    }
+
+    inline void split(double a, double &hi, double &lo) {
+        double c = kSplitter * a;
+        double abig = c - a;
+        hi = c - abig;
+        lo = a - hi;
+    }
+
+    inline void twoProduct(double a, double b, double &x, double &y) {
+        x = a * b;
+        double ahi, alo, bhi, blo;
+        split(a, ahi, alo);
+        split(b, bhi, blo);
+        double err1 = x - ahi * bhi;
+        double err2 = err1 - alo * bhi;
+        double err3 = err2 - ahi * blo;
+        y = alo * blo - err3;
+    }
+
+    // (a1 + a0) - b = x2 + x1 + x0
+    inline void twoOneDiff(double a1, double a0, double b, double &x2, double &x1, double &x0) {
+        double i;
+        twoDiff(a0, b, i, x0);
+        twoSum(a1, i, x2, x1);
+    }
+
+    // (a1 + a0) - (b1 + b0) = x[3] + x[2] + x[1] + x[0]
+    inline void twoTwoDiff(double a1, double a0, double b1, double b0, double x[4]) {
+        double j, z;
+        twoOneDiff(a1, a0, b0, j, z, x[0]);
+        twoOneDiff(j, z, b1, x[3], x[2], x[1]);
+    }
+
+    double estimate(int n, const double *e) {
+        double q = e[0];
+        for (int i = 1; i < n; ++i)
+            q += e[i];
+        return q;
+    }
+
+    // h = e + f (nonoverlapping expansion, 0 인 성분은 버림). h 의 길이를 반환
+    int fastExpansionSumZeroElim(int elen, const double *e, int flen, const double *f, double *h) {
+        int ei = 0, fi = 0, hi = 0;
+        double enow = e[0], fnow = f[0];
+        double q, qnew, hh;
+        auto nextE = [&]() { ++ei; if (ei < elen) enow = e[ei]; };
+        auto nextF = [&]() { ++fi; if (fi < flen) fnow = f[fi]; };
+
+        if ((fnow > enow) == (fnow > -enow)) { q = enow; nextE(); }
+        else                                 { q = fnow; nextF(); }
+
+        if (ei < elen && fi < flen) {
+            if ((fnow > enow) == (fnow > -enow)) { fastTwoSum(enow, q, qnew, hh); nextE(); }
+            else                                 { fastTwoSum(fnow, q, qnew, hh); nextF(); }
+            q = qnew;
+            if (hh != 0.0) h[hi++] = hh;
+            while (ei < elen && fi < flen) {
+                if ((fnow > enow) == (fnow > -enow)) { twoSum(q, enow, qnew, hh); nextE(); }
+                else                                 { twoSum(q, fnow, qnew, hh); nextF(); }
+                q = qnew;
+                if (hh != 0.0) h[hi++] = hh;
+            }
+        }
+        while (ei < elen) {
+            twoSum(q, enow, qnew, hh);
+            nextE();
+            q = qnew;
+            if (hh != 0.0) h[hi++] = hh;
+        }
+        while (fi < flen) {
+            twoSum(q, fnow, qnew, hh);
+            nextF();
+            q = qnew;
+            if (hh != 0.0) h[hi++] = hh;
+        }
+        if (q != 0.0 || hi == 0) h[hi++] = q;
+        return hi;
+    }
+
+    int sign(double v) { return (v > 0.0) - (v < 0.0); }
+
+    // 계산 순서는 Shewchuk 와 같이 (a - c) x (b - c). 부호는 (b - a) x (c - a) 와 같다
+    double orient2dAdapt(const Vec2 &pa, const Vec2 &pb, const Vec2 &pc, double detsum) {
+        const double acx = pa.x - pc.x;
+        const double bcx = pb.x - pc.x;
+        const double acy = pa.y - pc.y;
+        const double bcy = pb.y - pc.y;
+
+        double detleft, detlefttail, detright, detrighttail;
+        twoProduct(acx, bcy, detleft, detlefttail);
+        twoProduct(acy, bcx, detright, detrighttail);
+
+        double B[4];
+        twoTwoDiff(detleft, detlefttail, detright, detrighttail, B);
+
+        double det = estimate(4, B);
+        double errbound = kCcwErrBoundB * detsum;
+        if (det >= errbound || -det >= errbound)
+            return det;
+
+        double acxtail, bcxtail, acytail, bcytail;
+        twoDiffTail(pa.x, pc.x, acx, acxtail);
+        twoDiffTail(pb.x, pc.x, bcx, bcxtail);
+        twoDiffTail(pa.y, pc.y, acy, acytail);
+        twoDiffTail(pb.y, pc.y, bcy, bcytail);
+
+        if (acxtail == 0.0 && acytail == 0.0 && bcxtail == 0.0 && bcytail == 0.0)
+            return det;
+
+        errbound = kCcwErrBoundC * detsum + kResultErrBound * std::fabs(det);
+        det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+        if (det >= errbound || -det >= errbound)
+            return det;
+
+        double s1, s0, t1, t0, u[4];
+        double C1[8], C2[12], D[16];
+
+        twoProduct(acxtail, bcy, s1, s0);
+        twoProduct(acytail, bcx, t1, t0);
+        twoTwoDiff(s1, s0, t1, t0, u);
+        const int c1len = fastExpansionSumZeroElim(4, B, 4, u, C1);
+
+        twoProduct(acx, bcytail, s1, s0);
+        twoProduct(acy, bcxtail, t1, t0);
+        twoTwoDiff(s1, s0, t1, t0, u);
+        const int c2len = fastExpansionSumZeroElim(c1len, C1, 4, u, C2);
+
+        twoProduct(acxtail, bcytail, s1, s0);
+        twoProduct(acytail, bcxtail, t1, t0);
+        twoTwoDiff(s1, s0, t1, t0, u);
+        const int dlen = fastExpansionSumZeroElim(c2len, C2, 4, u, D);
+
+        return D[dlen - 1];
+    }
+}
+
+int predicates::orient2dExact(const Vec2 &a, const Vec2 &b, const Vec2 &c) {
+    // stage A (Shewchuk 의 dynamic filter) 부터
+    const double detleft = (a.x - c.x) * (b.y - c.y);
+    const double detright = (a.y - c.y) * (b.x - c.x);
+    const double det = detleft - detright;
+
+    double detsum;
+    if (detleft > 0.0) {
+        if (detright <= 0.0) return sign(det);
+        detsum = detleft + detright;
+    } else if (detleft < 0.0) {
+        if (detright >= 0.0) return sign(det);
+        detsum = -detleft - detright;
+    } else {
+        return sign(det);
+    }
+
+    const double errbound = kCcwErrBoundA * detsum;
+    if (det >= errbound || -det >= errbound)
+        return sign(det);
+
+    return sign(orient2dAdapt(a, b, c, detsum));
+}
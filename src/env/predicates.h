@@ -0,0 +1,42 @@
+// /src/env/predicates.h
+#pragma once
+#include <cmath>
+#include "vec2.h"
+
+// 정확한 orientation predicate (부호만 필요할 때)
+// 1) semi-static filter: 좌표 차이의 크기로 오차 한계를 잡아 거의 모든 호출을 double 연산 한 번으로 끝낸다
+// 2) filter 로 결정하지 못한 경우 (거의 collinear) 만 adaptive precision exact 연산 (predicates.cc)
+// epsilon 없이 항상 실제 부호를 돌려주므로 호출하는 쪽끼리 답이 어긋나지 않는다
+namespace predicates {
+    // (b - a) x (c - a) 의 오차 한계 계수: |err| <= kOrientFilter * max|dx| * max|dy|
+    // (차이 계산의 반올림까지 포함, CGAL Orientation_2 filter 와 같은 값)
+    constexpr double kOrientFilter = 8.8872057372592798e-16;
+    // 이 범위 밖이면 한계 계산이 underflow / overflow 하므로 exact 로 보낸다
+    constexpr double kFilterMin = 1e-146;
+    constexpr double kFilterMax = 1e153;
+
+    // filter 를 통과하지 못한 경우의 exact 부호 (Shewchuk orient2d 의 adaptive 단계)
+    int orient2dExact(const Vec2 &a, const Vec2 &b, const Vec2 &c);
+}
+
+// a -> b -> c 가 CCW 면 1, CW 면 -1, 정확히 일직선이면 0
+// (부호는 (b - a) x (c - a) 와 같다)
+inline int orient2d(const Vec2 &a, const Vec2 &b, const Vec2 &c) {
+    const double abx = b.x - a.x, aby = b.y - a.y;
+    const double acx = c.x - a.x, acy = c.y - a.y;
+    const double det = abx * acy - aby * acx;
+
+    const double mx = std::fmax(std::fabs(abx), std::fabs(acx));
+    const double my = std::fmax(std::fabs(aby), std::fabs(acy));
+    const double lo = std::fmin(mx, my);
+    const double hi = std::fmax(mx, my);
+    if (lo < predicates::kFilterMin) {
+        if (lo == 0.0)
+            return 0;  // x 차이 또는 y 차이가 모두 0 (차이 계산은 0 일 때만 0 이 된다)
+    } else if (hi < predicates::kFilterMax) {
+        const double eps = predicates::kOrientFilter * mx * my;
+        if (det > eps) return 1;
+        if (det < -eps) return -1;
+    }
+    return predicates::orient2dExact(a, b, c);
+}
@@ -1,25 +1,253 @@
 // /home/changmin/PyProject/planning-example/src/env/rng.h
 #pragma once
-#include <random>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11)
+// counter 4 word 를 key 2 word 로 섞는 bijection. 상태가 counter 뿐이라
+// 어느 위치든 바로 계산할 수 있고, counter 영역이 다르면 서로 독립인 stream 이 된다
+struct Philox4x32 {
+    static void generate(const std::uint32_t ctr[4], const std::uint32_t key[2], std::uint32_t out[4]) {
+        constexpr std::uint32_t kM0 = 0xD2511F53u, kM1 = 0xCD9E8D57u;
+        constexpr std::uint32_t kW0 = 0x9E3779B9u, kW1 = 0xBB67AE85u;
+        std::uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        std::uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                k0 += kW0;
+                k1 += kW1;
+            }
+            const std::uint64_t p0 = static_cast<std::uint64_t>(kM0) * c0;
+            const std::uint64_t p1 = static_cast<std::uint64_t>(kM1) * c2;
+            const std::uint32_t hi0 = static_cast<std::uint32_t>(p0 >> 32), lo0 = static_cast<std::uint32_t>(p0);
+            const std::uint32_t hi1 = static_cast<std::uint32_t>(p1 >> 32), lo1 = static_cast<std::uint32_t>(p1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+    // counter 가 (first + j, c1, c2, c3) 인 block kLanes 개를 한 번에
+    // out[w][j] = block j 의 w 번째 word. SSE2 (x86-64 기본) 가 있으면 4 lane 씩 mul_epu32 로
+    static constexpr int kLanes = 8;
+    static void generateLanes(std::uint32_t first, std::uint32_t c1, std::uint32_t c2, std::uint32_t c3,
+                              const std::uint32_t key[2], std::uint32_t out[4][kLanes]) {
+        constexpr std::uint32_t kM0 = 0xD2511F53u, kM1 = 0xCD9E8D57u;
+        constexpr std::uint32_t kW0 = 0x9E3779B9u, kW1 = 0xBB67AE85u;
+#ifdef __SSE2__
+        // 4 lane 의 32x32 -> 64 곱: 짝수 lane / 홀수 lane 을 따로 곱하고 hi, lo 를 다시 모은다
+        auto mulhilo = [](__m128i x, __m128i m, __m128i &hi, __m128i &lo) {
+            const __m128i p02 = _mm_mul_epu32(x, m);
+            const __m128i p13 = _mm_mul_epu32(_mm_srli_epi64(x, 32), m);
+            lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0)),
+                                    _mm_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0)));
+            hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(p02, _MM_SHUFFLE(2, 0, 3, 1)),
+                                    _mm_shuffle_epi32(p13, _MM_SHUFFLE(2, 0, 3, 1)));
+        };
+        const __m128i m0 = _mm_set1_epi32(static_cast<int>(kM0));
+        const __m128i m1 = _mm_set1_epi32(static_cast<int>(kM1));
+        for (int g = 0; g < kLanes; g += 4) {
+            // block 번호는 2^32 에서 wrap 하므로 unsigned 로 더하고 lane 에 넣을 때만 int 로
+            const std::uint32_t base = first + static_cast<std::uint32_t>(g);
+            __m128i x0 = _mm_setr_epi32(static_cast<int>(base), static_cast<int>(base + 1u),
+                                        static_cast<int>(base + 2u), static_cast<int>(base + 3u));
+            __m128i x1 = _mm_set1_epi32(static_cast<int>(c1));
+            __m128i x2 = _mm_set1_epi32(static_cast<int>(c2));
+            __m128i x3 = _mm_set1_epi32(static_cast<int>(c3));
+            std::uint32_t k0 = key[0], k1 = key[1];
+            for (int round = 0; round < 10; ++round) {
+                if (round > 0) {
+                    k0 += kW0;
+                    k1 += kW1;
+                }
+                __m128i hi0, lo0, hi1, lo1;
+                mulhilo(x0, m0, hi0, lo0);
+                mulhilo(x2, m1, hi1, lo1);
+                x0 = _mm_xor_si128(_mm_xor_si128(hi1, x1), _mm_set1_epi32(static_cast<int>(k0)));
+                x1 = lo1;
+                x2 = _mm_xor_si128(_mm_xor_si128(hi0, x3), _mm_set1_epi32(static_cast<int>(k1)));
+                x3 = lo0;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[0][g]), x0);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[1][g]), x1);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[2][g]), x2);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[3][g]), x3);
+        }
+#else
+        (void)kM0; (void)kM1; (void)kW0; (void)kW1;
+        for (int j = 0; j < kLanes; ++j) {
+            const std::uint32_t ctr[4] = {first + static_cast<std::uint32_t>(j), c1, c2, c3};
+            std::uint32_t block[4];
+            generate(ctr, key, block);
+            for (int w = 0; w < 4; ++w)
+                out[w][j] = block[w];
+        }
+#endif
+    }
+};
+
+// (seed, stream, substream) 로 정해지는 독립 난수열
+// - key = seed (64 bit), counter = { block, substream, stream 하위, stream 상위 }
+//   → substream 하나에 2^32 block (= 2^34 개의 32 bit 값) 까지 겹치지 않는다
+// - 같은 (seed, stream, substream) 이면 어느 thread 에서 만들든 같은 값이 나오므로,
+//   작업 i 가 substream(i) 를 쓰면 thread 수와 상관없이 결과가 같다
+// - 분포 변환도 직접 하므로 (std::*_distribution 은 구현마다 다르다) 플랫폼이 달라도 같은 값
+class RandomStream {
+public:
+    using result_type = std::uint32_t;
+
+    RandomStream() : RandomStream(0, 0, 0) {}
+    RandomStream(std::uint64_t seed, std::uint64_t stream, std::uint32_t substream = 0)
+        : seed_(seed), stream_(stream), substream_(substream) {}
+
+    std::uint64_t seed() const { return seed_; }
+    std::uint64_t stream() const { return stream_; }
+    std::uint32_t substreamId() const { return substream_; }
+
+    // 같은 seed / stream 의 i 번째 substream (처음 위치부터)
+    RandomStream substream(std::uint32_t i) const { return RandomStream(seed_, stream_, i); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (lane_ == 4)
+            refill();
+        return buf_[lane_++];
+    }
+
+    std::uint64_t nextU64() {
+        const std::uint64_t hi = (*this)();
+        const std::uint64_t lo = (*this)();
+        return (hi << 32) | lo;
+    }
+
+    // [a, b) 균등 (53 bit)
+    double uniform(double a = 0.0, double b = 1.0) {
+        const double u = static_cast<double>(nextU64() >> 11) * (1.0 / 9007199254740992.0);
+        return a + (b - a) * u;
+    }
+
+    // 정규분포 (Box-Muller, uniform 두 개를 쓰고 한 값만 돌려준다)
+    // log/cos 는 libm 을 쓰므로 플랫폼이 다르면 마지막 bit 가 다를 수 있다
+    double normal(double mean = 0.0, double stddev = 1.0) {
+        constexpr double kTwoPi = 6.283185307179586;
+        const double u1 = 1.0 - uniform();  // (0, 1]
+        const double u2 = uniform();
+        return mean + stddev * std::sqrt(-2.0 * std::log(u1)) * std::cos(kTwoPi * u2);
+    }
+
+    // uniform(a, b) 를 n 번 부른 것과 같은 값을 out 에 (같은 만큼 stream 이 진행한다)
+    // block 경계에 맞춰져 있으면 Philox4x32::generateLanes 로 여러 block 을 한 번에 만든다
+    void fillUniform(double *out, std::size_t n, double a, double b) {
+        constexpr double kScale = 1.0 / 9007199254740992.0;
+        // 남은 buffer 를 먼저 쓴다 (홀수 위치면 끝까지 scalar 로)
+        while (n > 0 && lane_ != 4) {
+            *out++ = uniform(a, b);
+            --n;
+        }
+        const std::uint32_t key[2] = {static_cast<std::uint32_t>(seed_),
+                                      static_cast<std::uint32_t>(seed_ >> 32)};
+        const std::uint32_t c2 = static_cast<std::uint32_t>(stream_);
+        const std::uint32_t c3 = static_cast<std::uint32_t>(stream_ >> 32);
+        constexpr std::size_t kPerCall = 2 * Philox4x32::kLanes;  // block 하나에 double 2개
+        std::uint32_t w[4][Philox4x32::kLanes];
+        while (n >= kPerCall) {
+            Philox4x32::generateLanes(block_, substream_, c2, c3, key, w);
+            block_ += Philox4x32::kLanes;
+            for (int j = 0; j < Philox4x32::kLanes; ++j) {
+                const std::uint64_t u0 = (static_cast<std::uint64_t>(w[0][j]) << 32) | w[1][j];
+                const std::uint64_t u1 = (static_cast<std::uint64_t>(w[2][j]) << 32) | w[3][j];
+                out[2 * j]     = a + (b - a) * (static_cast<double>(u0 >> 11) * kScale);
+                out[2 * j + 1] = a + (b - a) * (static_cast<double>(u1 >> 11) * kScale);
+            }
+            out += kPerCall;
+            n -= kPerCall;
+        }
+        while (n > 0) {
+            *out++ = uniform(a, b);
+            --n;
+        }
+    }
+
+    // [a, b] 정수 균등 (Lemire 의 곱셈 방식, bias 없음)
+    int uniformInt(int a, int b) {
+        const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(b) - a) + 1;
+        if (range > 0xFFFFFFFFull)
+            return static_cast<int>(static_cast<std::int64_t>(a) + (*this)());
+        const std::uint32_t s = static_cast<std::uint32_t>(range);
+        std::uint64_t m = static_cast<std::uint64_t>((*this)()) * s;
+        std::uint32_t l = static_cast<std::uint32_t>(m);
+        if (l < s) {
+            const std::uint32_t t = (0u - s) % s;
+            while (l < t) {
+                m = static_cast<std::uint64_t>((*this)()) * s;
+                l = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<int>(static_cast<std::int64_t>(a) + static_cast<std::int64_t>(m >> 32));
+    }
+
+private:
+    void refill() {
+        const std::uint32_t ctr[4] = {block_++, substream_,
+                                      static_cast<std::uint32_t>(stream_),
+                                      static_cast<std::uint32_t>(stream_ >> 32)};
+        const std::uint32_t key[2] = {static_cast<std::uint32_t>(seed_),
+                                      static_cast<std::uint32_t>(seed_ >> 32)};
+        Philox4x32::generate(ctr, key, buf_);
+        lane_ = 0;
+    }
+
+    std::uint64_t seed_;
+    std::uint64_t stream_;
+    std::uint32_t substream_;
+    std::uint32_t block_ = 0;
+    std::uint32_t buf_[4] = {0, 0, 0, 0};
+    int lane_ = 4;
+};
+
+// 용도별 stream 번호 (같은 seed 에서 서로 겹치지 않게)
+namespace rng_stream {
+    constexpr std::uint64_t kEnvironment = 0;  // build_env 의 obstacle 생성
+
+    // roadmap 종류마다 다른 stream (이름의 FNV-1a hash, kEnvironment 와 겹치지 않게 최상위 bit 를 세운다)
+    inline std::uint64_t forName(const char *name) {
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        for (const char *c = name; *c; ++c) {
+            h ^= static_cast<unsigned char>(*c);
+            h *= 0x100000001b3ull;
+        }
+        return h | (1ull << 63);
+    }
+}
 
 class RNG {
 public:
-    static std::mt19937& get() {
-        static std::mt19937 rng_instance;
-        return rng_instance;
+    // thread 마다 따로 가진다 (여러 thread 가 각자 seed 해서 써도 서로 섞이지 않음)
+    // 병렬 작업은 이 stream 을 복사해서 작업마다 substream(i) 를 쓴다
+    static RandomStream& stream() {
+        static thread_local RandomStream stream_instance;
+        return stream_instance;
     }
 
-    static void seed(unsigned int s) {
-        get().seed(s);
+    static void seed(std::uint64_t s, std::uint64_t stream_id = rng_stream::kEnvironment) {
+        stream() = RandomStream(s, stream_id);
     }
 
     static double uniform(double a = 0.0, double b = 1.0) {
-        std::uniform_real_distribution<double> dist(a, b);
-        return dist(get());
+        return stream().uniform(a, b);
     }
 
     static int uniformInt(int a, int b) {
-        std::uniform_int_distribution<int> dist(a, b); // inclusive
-        return dist(get());
+        return stream().uniformInt(a, b);  // inclusive
     }
 };
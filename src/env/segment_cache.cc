@@ -0,0 +1,198 @@
+// /src/env/segment_cache.cc
+#include "segment_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    std::uint64_t mix(std::uint64_t h) {
+        // splitmix64 finalizer
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    std::int64_t bits(double v) {
+        if (v == 0.0) v = 0.0;  // -0.0 와 0.0 을 같은 key 로
+        std::int64_t r;
+        std::memcpy(&r, &v, sizeof(r));
+        return r;
+    }
+
+    std::uint64_t toBits(double v) {
+        std::uint64_t r;
+        std::memcpy(&r, &v, sizeof(r));
+        return r;
+    }
+
+    double fromBits(std::uint64_t r) {
+        double v;
+        std::memcpy(&v, &r, sizeof(v));
+        return v;
+    }
+}
+
+SegmentCache::SegmentCache(const SegmentCache &other) {
+    configure(other.capacity(), other.quantum_);
+}
+
+SegmentCache &SegmentCache::operator=(const SegmentCache &other) {
+    if (this != &other)
+        configure(other.capacity(), other.quantum_);
+    return *this;
+}
+
+void SegmentCache::configure(std::size_t capacity, double quantum) {
+    quantum_ = std::max(0.0, quantum);
+    buckets_ = (capacity + kWays - 1) / kWays;
+    slot_count_ = buckets_ * kWays;
+    slots_.reset(slot_count_ > 0 ? new Slot[slot_count_] : nullptr);
+    victim_.assign(buckets_, 0);
+    resetCounters();
+}
+
+void SegmentCache::clear() {
+    for (std::size_t bucket = 0; bucket < buckets_; ++bucket) {
+        std::lock_guard<std::mutex> lock(stripes_[bucket % kStripes].lock);
+        for (int w = 0; w < kWays; ++w)
+            writeSlot(slots_[bucket * kWays + w], Key{}, Vec2(), Vec2(), 0, 0);
+        victim_[bucket] = 0;
+    }
+}
+
+std::uint64_t SegmentCache::hits() const {
+    std::uint64_t n = 0;
+    for (const Stripe &s : stripes_)
+        n += s.hits.load(std::memory_order_relaxed);
+    return n;
+}
+
+std::uint64_t SegmentCache::misses() const {
+    std::uint64_t n = 0;
+    for (const Stripe &s : stripes_)
+        n += s.misses.load(std::memory_order_relaxed);
+    return n;
+}
+
+void SegmentCache::resetCounters() {
+    for (Stripe &s : stripes_) {
+        s.hits.store(0, std::memory_order_relaxed);
+        s.misses.store(0, std::memory_order_relaxed);
+    }
+}
+
+SegmentCache::Key SegmentCache::makeKey(const Vec2 &a, const Vec2 &b, bool &swapped) const {
+    auto q = [&](double v) -> std::int64_t {
+        return quantum_ > 0.0 ? static_cast<std::int64_t>(std::llround(v / quantum_)) : bits(v);
+    };
+    Key ka{{q(a.x), q(a.y), q(b.x), q(b.y)}};
+    // (a, b) 와 (b, a) 를 같은 key 로
+    swapped = ka.k[2] < ka.k[0] || (ka.k[2] == ka.k[0] && ka.k[3] < ka.k[1]);
+    if (swapped) {
+        std::swap(ka.k[0], ka.k[2]);
+        std::swap(ka.k[1], ka.k[3]);
+    }
+    return ka;
+}
+
+std::size_t SegmentCache::bucketOf(const Key &key) const {
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (std::int64_t v : key.k)
+        h = mix(h ^ static_cast<std::uint64_t>(v));
+    return static_cast<std::size_t>(h % buckets_);
+}
+
+bool SegmentCache::readSlot(const Slot &slot, const Key &key, std::uint64_t version, Entry &out) {
+    const std::uint32_t before = slot.seq.load(std::memory_order_acquire);
+    if (before & 1u)
+        return false;
+    // 찢어진 값으로 틀린 "불일치" 가 나와도 miss 일 뿐이고, 틀린 "일치" 는 마지막 seq 확인에서 걸러진다
+    out.state = slot.state.load(std::memory_order_relaxed);
+    if (!(out.state & kValid) || slot.version.load(std::memory_order_relaxed) != version)
+        return false;
+    for (int i = 0; i < 4; ++i) {
+        if (slot.key[i].load(std::memory_order_relaxed) != key.k[i])
+            return false;
+    }
+    out.a = Vec2(fromBits(slot.ends[0].load(std::memory_order_relaxed)),
+                 fromBits(slot.ends[1].load(std::memory_order_relaxed)));
+    out.b = Vec2(fromBits(slot.ends[2].load(std::memory_order_relaxed)),
+                 fromBits(slot.ends[3].load(std::memory_order_relaxed)));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == before;
+}
+
+void SegmentCache::writeSlot(Slot &slot, const Key &key, const Vec2 &a, const Vec2 &b,
+                             std::uint64_t version, std::uint8_t state) {
+    const std::uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < 4; ++i)
+        slot.key[i].store(key.k[i], std::memory_order_relaxed);
+    slot.ends[0].store(toBits(a.x), std::memory_order_relaxed);
+    slot.ends[1].store(toBits(a.y), std::memory_order_relaxed);
+    slot.ends[2].store(toBits(b.x), std::memory_order_relaxed);
+    slot.ends[3].store(toBits(b.y), std::memory_order_relaxed);
+    slot.version.store(version, std::memory_order_relaxed);
+    slot.state.store(state, std::memory_order_relaxed);
+    slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+bool SegmentCache::lookup(const Vec2 &a, const Vec2 &b, std::uint64_t version, bool &free) const {
+    if (!enabled())
+        return false;
+    bool swapped;
+    const Key key = makeKey(a, b, swapped);
+    const Vec2 &ka = swapped ? b : a;
+    const Vec2 &kb = swapped ? a : b;
+    const std::size_t bucket = bucketOf(key);
+    Stripe &stripe = stripes_[bucket % kStripes];
+    const Slot *set = &slots_[bucket * kWays];
+    for (int w = 0; w < kWays; ++w) {
+        Entry e;
+        if (!readSlot(set[w], key, version, e))
+            continue;  // 다른 key / version, 또는 쓰는 중인 칸
+        const bool entry_free = (e.state & kFree) != 0;
+        // 양자화로 같은 key 가 된 다른 선분의 "free" 는 이 선분에 대해 보장되지 않는다
+        const bool same = e.a.x == ka.x && e.a.y == ka.y && e.b.x == kb.x && e.b.y == kb.y;
+        if (!same && entry_free)
+            break;
+        free = entry_free;
+        stripe.hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    stripe.misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void SegmentCache::insert(const Vec2 &a, const Vec2 &b, std::uint64_t version, bool free) {
+    if (!enabled())
+        return;
+    bool swapped;
+    const Key key = makeKey(a, b, swapped);
+    const std::size_t bucket = bucketOf(key);
+    std::lock_guard<std::mutex> lock(stripes_[bucket % kStripes].lock);
+    Slot *set = &slots_[bucket * kWays];
+
+    // 빈 칸, 다른 version (이미 무효), 같은 key 인 칸을 먼저 쓰고, 없으면 round robin
+    // (칸은 이 lock 안에서만 바뀌므로 seq 확인 없이 읽어도 된다)
+    int slot = -1;
+    for (int w = 0; w < kWays && slot < 0; ++w) {
+        const Slot &s = set[w];
+        bool same_key = true;
+        for (int i = 0; i < 4; ++i)
+            same_key = same_key && s.key[i].load(std::memory_order_relaxed) == key.k[i];
+        if (!(s.state.load(std::memory_order_relaxed) & kValid) ||
+            s.version.load(std::memory_order_relaxed) != version || same_key)
+            slot = w;
+    }
+    if (slot < 0) {
+        slot = victim_[bucket];
+        victim_[bucket] = static_cast<std::uint8_t>((slot + 1) % kWays);
+    }
+    writeSlot(set[slot], key, swapped ? b : a, swapped ? a : b, version,
+              static_cast<std::uint8_t>(kValid | (free ? kFree : 0)));
+}
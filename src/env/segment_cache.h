@@ -0,0 +1,94 @@
+// /src/env/segment_cache.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "vec2.h"
+
+// segmentFree 결과를 기억해 두는 고정 크기 hash table (4-way set associative)
+// - key 는 양 끝점 (방향 무관). quantum > 0 이면 끝점을 quantum 격자로 양자화, 0 이면 bit 그대로
+// - 양자화하면 같은 key 에 다른 선분이 들어올 수 있다. 저장된 선분과 끝점이 정확히 같으면 그 결과를,
+//   다르면 "막힘" 일 때만 돌려준다 (보수적: 막힌 선분을 free 로 답하지는 않지만, 가까운 선분 때문에
+//   free 인 선분을 막힘으로 답할 수 있고 어느 선분이 먼저 들어갔는지 = query 순서에 따라 답이 달라진다)
+// - 각 항목에 환경 version 을 같이 저장하고, version 이 다르면 miss (obstacle 이 바뀌면 전부 무효)
+// - 여러 thread 에서 불러도 된다: lookup 은 lock 없이 칸마다 seqlock 으로 읽고 (쓰는 중인 칸은 miss),
+//   insert 끼리만 bucket 묶음 (stripe) 마다 lock. hit/miss 수도 stripe 마다 세고 읽을 때 더한다
+class SegmentCache {
+public:
+    SegmentCache() = default;
+    // 복사하면 설정만 가져오고 내용은 비운다
+    SegmentCache(const SegmentCache &other);
+    SegmentCache &operator=(const SegmentCache &other);
+
+    // capacity 개 정도를 담는다 (0 이면 사용 안 함)
+    void configure(std::size_t capacity, double quantum = 0.0);
+    void clear();
+
+    bool enabled() const { return slot_count_ > 0; }
+    std::size_t capacity() const { return slot_count_; }
+    double quantum() const { return quantum_; }
+
+    // version 에서 (a, b) 의 결과가 있으면 free 에 담고 true
+    bool lookup(const Vec2 &a, const Vec2 &b, std::uint64_t version, bool &free) const;
+    void insert(const Vec2 &a, const Vec2 &b, std::uint64_t version, bool free);
+
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+    void resetCounters();
+
+private:
+    static constexpr int kWays = 4;
+    static constexpr int kStripes = 64;
+
+    struct Key {
+        std::int64_t k[4];
+        bool operator==(const Key &o) const {
+            return k[0] == o.k[0] && k[1] == o.k[1] && k[2] == o.k[2] && k[3] == o.k[3];
+        }
+    };
+
+    // 한 칸. 필드는 모두 atomic 이라 읽는 도중 덮어써져도 data race 는 아니고,
+    // seq 를 앞뒤로 읽어 같을 때 (그 사이 쓰기가 없었을 때) 만 읽은 값을 쓴다
+    struct Slot {
+        std::atomic<std::uint32_t> seq{0};      // 홀수면 쓰는 중
+        std::atomic<std::int64_t>  key[4]{};
+        std::atomic<std::uint64_t> ends[4]{};   // 저장한 선분의 실제 끝점 a.x, a.y, b.x, b.y (key 순서, double bit)
+        std::atomic<std::uint64_t> version{0};
+        std::atomic<std::uint8_t>  state{0};    // kValid | kFree
+    };
+    static constexpr std::uint8_t kValid = 1;
+    static constexpr std::uint8_t kFree = 2;
+
+    // lookup 이 Slot 에서 읽은 값
+    struct Entry {
+        Vec2 a, b;
+        std::uint8_t state;
+    };
+
+    // insert 끼리의 lock 과 hit/miss 수 (stripe 마다 cache line 하나)
+    struct alignas(64) Stripe {
+        std::mutex lock;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+    };
+
+    // swapped 에는 key 를 만들면서 (a, b) 를 뒤집었는지
+    Key makeKey(const Vec2 &a, const Vec2 &b, bool &swapped) const;
+    std::size_t bucketOf(const Key &key) const;
+    // slot 이 (key, version) 의 유효한 결과이면 끝점과 state 를 out 에 담고 true (lock 없이, 쓰는 중이었으면 false)
+    static bool readSlot(const Slot &slot, const Key &key, std::uint64_t version, Entry &out);
+    // 같은 stripe 의 lock 을 잡고 부른다
+    static void writeSlot(Slot &slot, const Key &key, const Vec2 &a, const Vec2 &b,
+                          std::uint64_t version, std::uint8_t state);
+
+    double quantum_ = 0.0;
+    std::size_t buckets_ = 0;
+    std::size_t slot_count_ = 0;            // buckets_ * kWays
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<std::uint8_t> victim_;     // bucket 마다 다음에 덮어쓸 way (round robin, stripe lock 안에서만)
+    mutable std::array<Stripe, kStripes> stripes_;
+};
@@ -0,0 +1,64 @@
+// /src/env/slab_locator.cc
+#include "slab_locator.h"
+#include "collision_stats.h"
+#include "predicates.h"
+#include <algorithm>
+
+SlabLocator::SlabLocator(const std::vector<Vec2> &pts) {
+    const int n = static_cast<int>(pts.size());
+    ys_.reserve(n);
+    for (const auto &p : pts)
+        ys_.push_back(p.y);
+    std::sort(ys_.begin(), ys_.end());
+    ys_.erase(std::unique(ys_.begin(), ys_.end()), ys_.end());
+
+    const int num_slabs = std::max(0, static_cast<int>(ys_.size()) - 1);
+    std::vector<std::vector<SlabEdge>> slabs(num_slabs);
+
+    for (int i = 0; i < n; ++i) {
+        const Vec2 &a = pts[i];
+        const Vec2 &b = pts[(i + 1) % n];
+        if (a.y == b.y)
+            continue;  // 수평 edge 는 ray casting 에서도 세지 않는다
+        const Vec2 &lo = (a.y < b.y) ? a : b;
+        const Vec2 &hi = (a.y < b.y) ? b : a;
+        SlabEdge e{lo, hi};
+
+        int s0 = static_cast<int>(std::lower_bound(ys_.begin(), ys_.end(), lo.y) - ys_.begin());
+        int s1 = static_cast<int>(std::lower_bound(ys_.begin(), ys_.end(), hi.y) - ys_.begin());
+        for (int s = s0; s < s1; ++s)
+            slabs[s].push_back(e);
+    }
+
+    slab_start_.assign(num_slabs + 1, 0);
+    for (int s = 0; s < num_slabs; ++s) {
+        // simple polygon 이므로 slab 안에서 edge 끼리 교차하지 않음 -> 중간 높이의 x 로 정렬
+        double ym = 0.5 * (ys_[s] + ys_[s + 1]);
+        std::sort(slabs[s].begin(), slabs[s].end(),
+                  [ym](const SlabEdge &l, const SlabEdge &r) { return l.xAt(ym) < r.xAt(ym); });
+        slab_start_[s + 1] = slab_start_[s] + static_cast<int>(slabs[s].size());
+        edges_.insert(edges_.end(), slabs[s].begin(), slabs[s].end());
+    }
+}
+
+bool SlabLocator::contains(const Vec2 &p) const {
+    if (ys_.size() < 2 || p.y < ys_.front() || p.y >= ys_.back())
+        return false;
+
+    // ys_[s] <= p.y < ys_[s+1]
+    int s = static_cast<int>(std::upper_bound(ys_.begin(), ys_.end(), p.y) - ys_.begin()) - 1;
+    int lo = slab_start_[s];
+    int hi = slab_start_[s + 1];
+
+    // p 오른쪽 (p.x < x_e, 즉 p 가 lo -> hi 의 왼쪽) 에 있는 첫 edge 를 찾고, 그 뒤의 edge 수 = ray 교차 수
+    const int end = hi;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        countEdgeTests(1);
+        if (orient2d(edges_[mid].lo, edges_[mid].hi, p) > 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return ((end - lo) & 1) != 0;
+}
@@ -0,0 +1,28 @@
+// /src/env/slab_locator.h
+#pragma once
+#include <vector>
+#include "vec2.h"
+
+// simple polygon 하나에 대한 slab 분할 point location
+// - vertex 의 y 값으로 수평 slab 을 나누고, slab 마다 걸치는 edge 를 x 순으로 정렬해 둔다
+// - contains 는 slab 이분 탐색 + slab 안 edge 이분 탐색 (O(log k), 나눗셈 없음)
+// - Obstacle::contains 의 ray casting 과 같은 half-open 규칙 (ymin <= y < ymax) 과
+//   같은 exact orient2d 판정을 쓰므로 경계 위의 점까지 항상 같은 답을 낸다
+// 메모리는 최악 O(k^2) 이지만 건물 footprint 같은 polygon 에서는 훨씬 작다.
+class SlabLocator {
+public:
+    explicit SlabLocator(const std::vector<Vec2> &pts);
+
+    bool contains(const Vec2 &p) const;
+
+private:
+    struct SlabEdge {
+        Vec2 lo, hi;  // lo.y < hi.y
+        // 정렬 (build) 에만 쓰는 근사값
+        double xAt(double y) const { return lo.x + (y - lo.y) * (hi.x - lo.x) / (hi.y - lo.y); }
+    };
+
+    std::vector<double>   ys_;          // 정렬된 slab 경계
+    std::vector<int>      slab_start_;  // slab s 의 edge 는 edges_[slab_start_[s] .. slab_start_[s+1])
+    std::vector<SlabEdge> edges_;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// scalar 타입별 2D 점 (double: 환경/충돌 검사, float: 큰 roadmap 저장용)
+template <class T>
+struct Vec2T {
+    T x, y;
+    Vec2T() : x(T(0)), y(T(0)) {}
+    Vec2T(T x_, T y_) : x(x_), y(y_) {}
+
+    // 다른 scalar 타입에서 변환 (double -> float 은 정밀도를 잃으므로 explicit)
+    template <class U>
+    explicit Vec2T(const Vec2T<U> &o) : x(static_cast<T>(o.x)), y(static_cast<T>(o.y)) {}
+};
+
+using Vec2  = Vec2T<double>;
+using Vec2f = Vec2T<float>;
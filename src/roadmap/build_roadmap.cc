@@ -3,39 +3,53 @@
 #include <fstream>
 #include <string>
 #include <chrono>                 // for timing
+#include <map>
+#include <memory>
+#include "env/collision_stats.h"
+#include "env/env_file.h"
 #include "env/environment.h"
 #include "env/rng.h"
+#include "roadmap/free_space.h"
 #include "roadmap/graph.h"
 #include "roadmap/prm.h"
 #include "roadmap/visibility.h"
 #include "roadmap/gvd.h"
 #include "roadmap/rrt.h"
 
-static void loadEnvironmentFromFile(const std::string &filename, Environment &env, unsigned int &seed_out) {
-    std::ifstream ifs(filename);
-    if (!ifs) {
-        throw std::runtime_error("Cannot open env file: " + filename);
+// 위치 인자 뒤에 오는 "--key=value" 옵션들을 읽는다
+static std::map<std::string, std::string> parseOptions(int argc, char** argv, int first) {
+    std::map<std::string, std::string> opts;
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0)
+            throw std::runtime_error("Unexpected argument: " + arg);
+        std::size_t eq = arg.find('=');
+        if (eq == std::string::npos)
+            opts[arg.substr(2)] = "1";
+        else
+            opts[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
     }
+    return opts;
+}
 
-    // First line: "# seed <value>"
-    std::string hash, word;
-    ifs >> hash >> word >> seed_out; // "# seed 12345"
-
-    int M;
-    ifs >> M;
-    env.obstacles.clear();
-    for (int i = 0; i < M; ++i) {
-        int k;
-        ifs >> k;
-        std::vector<Vec2> pts(k);
-        for (int j = 0; j < k; ++j) {
-            ifs >> pts[j].x >> pts[j].y;
-        }
-        env.obstacles.emplace_back(pts);
+// build 에 쓴 collision query counter 를 graph.txt.stats.json 같이 옆에 남긴다
+static void saveStatsToFile(const std::string &filename, const std::string &roadmap_tp,
+                            const std::string &collision, const Graph &g, double elapsed_s,
+                            const CollisionStats &stats) {
+    std::ofstream ofs(filename);
+    if (!ofs) {
+        throw std::runtime_error("Cannot open stats file for writing: " + filename);
     }
 
-    ifs >> env.start.x >> env.start.y;
-    ifs >> env.goal.x  >> env.goal.y;
+    ofs << "{\n";
+    ofs << "  \"roadmap_type\": \"" << roadmap_tp << "\",\n";
+    ofs << "  \"collision\": \"" << collision << "\",\n";
+    ofs << "  \"nodes\": " << g.nodes.size() << ",\n";
+    ofs << "  \"edges\": " << g.edges.size() << ",\n";
+    ofs << "  \"build_time_s\": " << elapsed_s << ",\n";
+    ofs << "  \"collision_stats\": ";
+    writeCollisionStatsJson(ofs, stats, 2);
+    ofs << "\n}\n";
 }
 
 static void saveGraphToFile(const std::string &filename, const Graph &g) {
@@ -60,30 +74,101 @@ static void saveGraphToFile(const std::string &filename, const Graph &g) {
 int main(int argc, char** argv) {
     if (argc < 4) {
         std::cerr << "Usage: " << argv[0]
-                  << " <env_file> <roadmap_type> <out_graph_file>\n";
-        std::cerr << "roadmap_type: prm_random | prm_halton | prm_sobol | visibility | gvd | rrt\n";
+                  << " <env_file> <roadmap_type> <out_graph_file> [options]\n";
+        std::cerr << "env_file: text (env.txt) or binary (build_env --format=binary)\n";
+        std::cerr << "roadmap_type: prm_random | prm_halton | prm_sobol | prm_gaussian | prm_bridge | prm_medial | prm_poisson | visibility | gvd | rrt\n";
+        std::cerr << "options:\n";
+        std::cerr << "  --collision=brute|grid|bvh|simd|conservative   collision checking backend (default: brute)\n";
+        std::cerr << "  --edge_kernel=auto|scalar|avx2    segment-vs-edges kernel (default: auto)\n";
+        std::cerr << "  --raster=<cell_size>              occupancy raster in front of isFree (default: off)\n";
+        std::cerr << "  --point_location=raycast|slab     Obstacle::contains method (default: raycast)\n";
+        std::cerr << "  --clearance=<cell_size>           clearance field resolution (conservative default: world/256)\n";
+        std::cerr << "  --ca_threshold=<dist>             conservative: exact check below this clearance\n";
+        std::cerr << "  --robot_radius=<r>                disc robot: check against inflated obstacles (default: 0)\n";
+        std::cerr << "  --segment_cache=<entries>         memoize segmentFree results (default: off)\n";
+        std::cerr << "  --segment_cache_quantum=<dist>    quantize cache keys to this grid (default: exact)\n";
+        std::cerr << "                                    approximate: nearby segments share blocked results,\n";
+        std::cerr << "                                    so free edges may be dropped and the graph may depend\n";
+        std::cerr << "                                    on query order (not deterministic with --threads)\n";
+        std::cerr << "  --poisson_spacing=<dist>          prm_poisson minimum node spacing (default: radius/2)\n";
+        std::cerr << "  --threads=<n>                     PRM worker threads, same graph for any n (default: all cores)\n";
+        std::cerr << "  --free_space=rejection|triangulated  PRM sampling of free space (default: rejection)\n";
+        std::cerr << "  --sobol_scramble=owen|digit|none  prm_sobol sequence scrambling (default: owen)\n";
+        std::cerr << "  --sampler_sigma=<dist>            prm_gaussian/bridge spread, prm_medial step (default: radius/4)\n";
         return 1;
     }
 
     std::string env_file   = argv[1];
     std::string roadmap_tp = argv[2];
     std::string out_file   = argv[3];
+    std::string collision  = "brute";
+    bool triangulated = false;
+    PRMOptions prm_opts;
+    prm_opts.threads = 0;
 
     Environment env;
     unsigned int env_seed = 0;
     try {
-        loadEnvironmentFromFile(env_file, env, env_seed);
+        std::map<std::string, std::string> opts = parseOptions(argc, argv, 4);
+        loadEnvironment(env_file, env, env_seed);
+
+        // 다른 index 들이 부풀린 obstacle 위에 만들어지도록 가장 먼저
+        if (opts.count("robot_radius"))
+            env.setRobotRadius(std::stod(opts["robot_radius"]));
+
+        if (opts.count("point_location")) {
+            const std::string &pl = opts["point_location"];
+            if (pl != "raycast" && pl != "slab")
+                throw std::runtime_error("Unknown point location: " + pl);
+            env.setSlabLocators(pl == "slab");
+        }
+        if (opts.count("clearance"))
+            env.setClearanceField(std::stod(opts["clearance"]));
+        if (opts.count("ca_threshold"))
+            env.setConservativeThreshold(std::stod(opts["ca_threshold"]));
+
+        CollisionMode mode = CollisionMode::BRUTE_FORCE;
+        if (opts.count("collision")) {
+            collision = opts["collision"];
+            mode = collisionModeFromString(collision);
+        }
+        env.setCollisionMode(mode);
+
+        if (opts.count("raster"))
+            env.setOccupancyRaster(std::stod(opts["raster"]));
+
+        if (opts.count("segment_cache")) {
+            double quantum = 0.0;
+            if (opts.count("segment_cache_quantum"))
+                quantum = std::stod(opts["segment_cache_quantum"]);
+            env.setSegmentCache(std::stoul(opts["segment_cache"]), quantum);
+        }
+
+        if (opts.count("free_space")) {
+            const std::string &fs = opts["free_space"];
+            if (fs != "rejection" && fs != "triangulated")
+                throw std::runtime_error("Unknown free space sampling: " + fs);
+            triangulated = (fs == "triangulated");
+        }
+
+        if (opts.count("sampler_sigma"))
+            prm_opts.narrow_sigma = std::stod(opts["sampler_sigma"]);
+        if (opts.count("threads"))
+            prm_opts.threads = std::stoi(opts["threads"]);
+        if (opts.count("poisson_spacing"))
+            prm_opts.poisson_spacing = std::stod(opts["poisson_spacing"]);
+        if (opts.count("sobol_scramble"))
+            prm_opts.sobol_scramble = sobolScrambleFromString(opts["sobol_scramble"]);
+
+        if (opts.count("edge_kernel"))
+            selectEdgeKernel(edgeKernelFromString(opts["edge_kernel"]));
     } catch (const std::exception &e) {
         std::cerr << "[build_roadmap] Error: " << e.what() << "\n";
         return 1;
     }
 
-    // Use environment seed + roadmap type hash to seed RNG for reproducible PRM/RRT
-    unsigned int seed = env_seed;
-    for (char c : roadmap_tp) {
-        seed = seed * 131u + static_cast<unsigned char>(c);
-    }
-    RNG::seed(seed);
+    // env seed 에서 roadmap 종류별 stream 을 만든다 (PRM/RRT 는 샘플마다 그 substream 을 쓴다)
+    RNG::seed(env_seed, rng_stream::forName(roadmap_tp.c_str()));
 
     // step 로그 파일: graph.txt.steps 같이 옆에 만든다
     std::string steps_file = out_file + ".steps";
@@ -95,16 +180,24 @@ int main(int argc, char** argv) {
     Graph g;
 
     try {
+        // 로드 / index 준비 중의 query (setRobotRadius 의 start/goal 검사 등) 는 빼고 센다
+        resetCollisionStats();
         auto t_start = std::chrono::high_resolution_clock::now();
 
         std::ostream *log = steps_ofs ? &steps_ofs : nullptr;
 
-        if (roadmap_tp == "prm_random" ||
-            roadmap_tp == "prm_halton" ||
-            roadmap_tp == "prm_sobol") {
+        if (roadmap_tp.rfind("prm_", 0) == 0) {
 
             SamplerType sampler = samplerFromString(roadmap_tp);
-            g = buildPRM(env, /*n_samples=*/400, sampler, /*radius=*/2.0, log);
+            // 삼각분할은 build 시간에 포함한다 (한 번 만들면 샘플마다 O(1))
+            std::unique_ptr<FreeSpaceSampler> free_space;
+            if (triangulated) {
+                free_space = std::make_unique<FreeSpaceSampler>(env);
+                std::cout << "[build_roadmap] free space: triangles=" << free_space->triangleCount()
+                          << " | area=" << free_space->freeArea() << std::endl;
+            }
+            prm_opts.free_space = free_space.get();
+            g = buildPRM(env, /*n_samples=*/400, sampler, /*radius=*/2.0, log, prm_opts);
 
         } else if (roadmap_tp == "visibility") {
             g = buildVisibilityGraph(env, log);
@@ -124,14 +217,20 @@ int main(int argc, char** argv) {
         auto t_end = std::chrono::high_resolution_clock::now();
         double elapsed_s =
             std::chrono::duration<double>(t_end - t_start).count();
+        CollisionStats stats = collisionStatsSnapshot();
 
         std::cout << "[build_roadmap] type=" << roadmap_tp
                   << " | nodes=" << g.nodes.size()
                   << " | edges=" << g.edges.size()
                   << " | build_time=" << elapsed_s << " s"
                   << std::endl;
+        if (env.segmentCache().enabled()) {
+            std::cout << "[build_roadmap] segment_cache hits=" << env.segmentCache().hits()
+                      << " | misses=" << env.segmentCache().misses() << std::endl;
+        }
 
         saveGraphToFile(out_file, g);
+        saveStatsToFile(out_file + ".stats.json", roadmap_tp, collision, g, elapsed_s, stats);
     } catch (const std::exception &e) {
         std::cerr << "[build_roadmap] Error while building roadmap: " << e.what() << "\n";
         return 1;
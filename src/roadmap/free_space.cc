@@ -0,0 +1,236 @@
+// /src/roadmap/free_space.cc
+#include "roadmap/free_space.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    struct Edge {
+        Vec2 a, b;
+    };
+
+    // slab 안에서 free 영역의 왼쪽/오른쪽 경계 하나 (edge 거나 cell 의 세로 경계)
+    struct Bound {
+        double x_lo, x_mid, x_hi;  // slab 의 아래 / 가운데 / 위 y 에서의 x
+    };
+
+    double xAt(const Edge &e, double y) {
+        return e.a.x + (y - e.a.y) * (e.b.x - e.a.x) / (e.b.y - e.a.y);
+    }
+
+    constexpr double kEdgesPerCell = 4.0;
+    constexpr int kMaxCellsPerSide = 1024;
+}
+
+FreeSpaceSampler::FreeSpaceSampler(const Environment &env) : version_(env.version()) {
+    const double r = env.robotRadius();
+    const double lo = env.world_min + r;
+    const double hi = env.world_max - r;
+    if (!(hi > lo))
+        return;
+
+    std::vector<Edge> edges;
+    for (const Obstacle &obs : env.obstacles) {
+        const std::size_t n = obs.pts.size();
+        for (std::size_t i = 0; i < n; ++i)
+            edges.push_back({obs.pts[i], obs.pts[(i + 1) % n]});
+    }
+
+    // edge bbox 가 걸치는 cell 들에 edge 를 등록 (CSR)
+    const int side = std::clamp(static_cast<int>(std::ceil(std::sqrt(edges.size() / kEdgesPerCell))),
+                                1, kMaxCellsPerSide);
+    const double cell = (hi - lo) / side;
+    auto cellOf = [&](double v) {
+        return std::clamp(static_cast<int>(std::floor((v - lo) / cell)), 0, side - 1);
+    };
+    auto forEachCell = [&](const Edge &e, auto &&fn) {
+        if (std::max(e.a.x, e.b.x) < lo || std::min(e.a.x, e.b.x) > hi ||
+            std::max(e.a.y, e.b.y) < lo || std::min(e.a.y, e.b.y) > hi)
+            return;
+        const int x0 = cellOf(std::min(e.a.x, e.b.x)), x1 = cellOf(std::max(e.a.x, e.b.x));
+        const int y0 = cellOf(std::min(e.a.y, e.b.y)), y1 = cellOf(std::max(e.a.y, e.b.y));
+        for (int cy = y0; cy <= y1; ++cy)
+            for (int cx = x0; cx <= x1; ++cx)
+                fn(cy * side + cx);
+    };
+    std::vector<std::uint32_t> start(static_cast<std::size_t>(side) * side + 1, 0);
+    for (const Edge &e : edges)
+        forEachCell(e, [&](int c) { ++start[c + 1]; });
+    for (std::size_t c = 1; c < start.size(); ++c)
+        start[c] += start[c - 1];
+    std::vector<std::uint32_t> cell_edges(start.back());
+    {
+        std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+        for (std::uint32_t i = 0; i < edges.size(); ++i)
+            forEachCell(edges[i], [&](int c) { cell_edges[fill[c]++] = i; });
+    }
+
+    std::vector<double> ys;
+    std::vector<Bound> bounds;
+    auto addTriangle = [&](const Vec2 &a, const Vec2 &b, const Vec2 &c) {
+        const double area = 0.5 * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+        if (area > 0.0)
+            tris_.push_back({a, b, c});
+    };
+
+    for (int cy = 0; cy < side; ++cy) {
+        const double cy0 = lo + cy * cell;
+        const double cy1 = (cy + 1 == side) ? hi : lo + (cy + 1) * cell;
+        for (int cx = 0; cx < side; ++cx) {
+            const double cx0 = lo + cx * cell;
+            const double cx1 = (cx + 1 == side) ? hi : lo + (cx + 1) * cell;
+            const std::uint32_t *ids = cell_edges.data() + start[cy * side + cx];
+            const std::uint32_t n_ids = start[cy * side + cx + 1] - start[cy * side + cx];
+
+            // slab 경계: cell 위아래, cell 안의 끝점, edge 가 cell 의 세로 경계를 지나는 곳
+            ys.clear();
+            ys.push_back(cy0);
+            ys.push_back(cy1);
+            auto addY = [&](double y) {
+                if (y > cy0 && y < cy1)
+                    ys.push_back(y);
+            };
+            for (std::uint32_t k = 0; k < n_ids; ++k) {
+                const Edge &e = edges[ids[k]];
+                addY(e.a.y);
+                addY(e.b.y);
+                const double ex0 = std::min(e.a.x, e.b.x), ex1 = std::max(e.a.x, e.b.x);
+                for (double x : {cx0, cx1}) {
+                    if (ex0 < x && x < ex1)
+                        addY(e.a.y + (x - e.a.x) * (e.b.y - e.a.y) / (e.b.x - e.a.x));
+                }
+            }
+            // 겹친 obstacle 의 edge 끼리 만나는 곳 (겹치지 않으면 끝점에서만 만난다)
+            for (std::uint32_t k = 0; k < n_ids; ++k) {
+                const Edge &e = edges[ids[k]];
+                for (std::uint32_t m = k + 1; m < n_ids; ++m) {
+                    const Edge &f = edges[ids[m]];
+                    const double dx1 = e.b.x - e.a.x, dy1 = e.b.y - e.a.y;
+                    const double dx2 = f.b.x - f.a.x, dy2 = f.b.y - f.a.y;
+                    const double den = dx1 * dy2 - dy1 * dx2;
+                    if (den == 0.0)
+                        continue;
+                    const double t = ((f.a.x - e.a.x) * dy2 - (f.a.y - e.a.y) * dx2) / den;
+                    const double u = ((f.a.x - e.a.x) * dy1 - (f.a.y - e.a.y) * dx1) / den;
+                    if (t > 0.0 && t < 1.0 && u > 0.0 && u < 1.0)
+                        addY(e.a.y + t * dy1);
+                }
+            }
+            std::sort(ys.begin(), ys.end());
+            ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+            for (std::size_t s = 0; s + 1 < ys.size(); ++s) {
+                const double y0 = ys[s], y1 = ys[s + 1];
+                const double ym = 0.5 * (y0 + y1);
+
+                bounds.clear();
+                bounds.push_back({cx0, cx0, cx0});
+                for (std::uint32_t k = 0; k < n_ids; ++k) {
+                    const Edge &e = edges[ids[k]];
+                    if (std::min(e.a.y, e.b.y) > y0 || std::max(e.a.y, e.b.y) < y1)
+                        continue;  // slab 을 가로지르지 않음 (가로 edge 포함)
+                    const double xm = xAt(e, ym);
+                    if (xm < cx0 || xm > cx1)
+                        continue;
+                    bounds.push_back({std::clamp(xAt(e, y0), cx0, cx1), xm,
+                                      std::clamp(xAt(e, y1), cx0, cx1)});
+                }
+                bounds.push_back({cx1, cx1, cx1});
+                std::sort(bounds.begin() + 1, bounds.end() - 1,
+                          [](const Bound &p, const Bound &q) { return p.x_mid < q.x_mid; });
+
+                // 이웃한 두 경계 사이는 다른 edge 가 지나지 않으므로 가운데 점 하나로 판정
+                for (std::size_t k = 0; k + 1 < bounds.size(); ++k) {
+                    const Bound &L = bounds[k];
+                    const Bound &R = bounds[k + 1];
+                    if (!(R.x_mid > L.x_mid))
+                        continue;
+                    if (!env.isFree(Vec2(0.5 * (L.x_mid + R.x_mid), ym)))
+                        continue;
+                    const Vec2 lb(L.x_lo, y0), rb(R.x_lo, y0), rt(R.x_hi, y1), lt(L.x_hi, y1);
+                    addTriangle(lb, rb, rt);
+                    addTriangle(lb, rt, lt);
+                }
+            }
+        }
+    }
+
+    // 면적 누적분포 (map) 와 Vose alias table (sample)
+    const std::size_t n = tris_.size();
+    std::vector<double> area(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const Triangle &t = tris_[i];
+        area[i] = 0.5 * ((t.b.x - t.a.x) * (t.c.y - t.a.y) - (t.c.x - t.a.x) * (t.b.y - t.a.y));
+        total_area_ += area[i];
+    }
+    if (n == 0)
+        return;
+
+    cdf_.resize(n);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += area[i];
+        cdf_[i] = acc / total_area_;
+    }
+    cdf_.back() = 1.0;
+
+    alias_prob_.resize(n);
+    alias_.resize(n);
+    std::vector<std::uint32_t> small, large;
+    std::vector<double> scaled(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        scaled[i] = area[i] / total_area_ * static_cast<double>(n);
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        const std::uint32_t s = small.back();
+        small.pop_back();
+        const std::uint32_t l = large.back();
+        alias_prob_[s] = scaled[s];
+        alias_[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // 남은 것은 (반올림 오차를 빼면) 정확히 1
+    for (std::uint32_t i : large) {
+        alias_prob_[i] = 1.0;
+        alias_[i] = i;
+    }
+    for (std::uint32_t i : small) {
+        alias_prob_[i] = 1.0;
+        alias_[i] = i;
+    }
+}
+
+Vec2 FreeSpaceSampler::pointInTriangle(const Triangle &t, double s, double r) const {
+    const double sq = std::sqrt(s);
+    const double wa = 1.0 - sq;
+    const double wb = sq * (1.0 - r);
+    const double wc = sq * r;
+    return Vec2(wa * t.a.x + wb * t.b.x + wc * t.c.x,
+                wa * t.a.y + wb * t.b.y + wc * t.c.y);
+}
+
+Vec2 FreeSpaceSampler::sample(RandomStream &rng) const {
+    const std::size_t n = tris_.size();
+    std::size_t i = static_cast<std::size_t>(rng.uniform(0.0, static_cast<double>(n)));
+    if (i >= n)
+        i = n - 1;
+    if (rng.uniform() >= alias_prob_[i])
+        i = alias_[i];
+    const double s = rng.uniform();
+    const double r = rng.uniform();
+    return pointInTriangle(tris_[i], s, r);
+}
+
+Vec2 FreeSpaceSampler::map(double u, double v) const {
+    const std::size_t i = std::min<std::size_t>(
+        static_cast<std::size_t>(std::upper_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin()),
+        cdf_.size() - 1);
+    const double c0 = i > 0 ? cdf_[i - 1] : 0.0;
+    const double w = cdf_[i] - c0;
+    const double s = w > 0.0 ? std::clamp((u - c0) / w, 0.0, 1.0) : 0.0;
+    return pointInTriangle(tris_[i], s, v);
+}
@@ -0,0 +1,51 @@
+// /src/roadmap/free_space.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "env/environment.h"
+#include "env/rng.h"
+
+// Environment 의 free space 를 한 번 삼각형으로 나눠 두고, rejection 없이 free 점을 뽑는 sampler
+// - world (robot radius 만큼 줄인) 를 uniform grid 로 자르고, cell 마다 그 cell 에 걸친 edge 들의
+//   끝점 / cell 경계 교차점의 y 로 slab 을 나눈다. slab 안에서는 edge 끼리 만나지 않으므로
+//   이웃한 두 경계 사이는 통째로 free 이거나 통째로 막혀 있고 (가운데 점 하나를 isFree 로 확인),
+//   free 인 사다리꼴을 삼각형 두 개로 쪼갠다
+// - obstacle 이 서로 겹치면 (robot radius 로 부풀린 경우 등) edge 끼리 만나는 y 도 slab 경계에 넣는다
+// - 삼각형 꼭짓점은 edge 위를 보간한 값이라 경계에서 반올림 오차만큼은 어긋날 수 있다
+// obstacle 이 바뀌면 (env.version() 이 오르면) 다시 만들어야 한다
+class FreeSpaceSampler {
+public:
+    struct Triangle {
+        Vec2 a, b, c;
+    };
+
+    explicit FreeSpaceSampler(const Environment &env);
+
+    bool empty() const { return tris_.empty(); }
+    double freeArea() const { return total_area_; }
+    std::size_t triangleCount() const { return tris_.size(); }
+    const std::vector<Triangle> &triangles() const { return tris_; }
+    std::uint64_t version() const { return version_; }  // 만들 때의 env.version()
+
+    // free space 위의 uniform 점. alias table 로 삼각형을 고르고 삼각형 안에서 uniform (O(1))
+    Vec2 sample(RandomStream &rng) const;
+
+    // [0,1)^2 의 점을 free space 로 옮긴다 (면적 누적분포의 역함수, O(log T))
+    // u 로 삼각형을 고르고 그 안의 나머지 비율과 v 로 삼각형 안의 점을 정한다.
+    // 면적은 보존하므로 uniform 점은 free space 위의 uniform 점이 된다. 하지만 연속은 아니다:
+    // 누적분포에서 이웃한 삼각형이 공간에서 이웃한 것은 아니어서, 고른 분포 (low discrepancy) 는
+    // 삼각형 하나 안에서만 유지되고 삼각형 사이에서는 보장되지 않는다
+    Vec2 map(double u, double v) const;
+
+private:
+    // 삼각형 안의 (s, t) in [0,1)^2 -> 점 (sqrt 매개화, 면적 보존)
+    Vec2 pointInTriangle(const Triangle &t, double s, double r) const;
+
+    std::vector<Triangle> tris_;
+    std::vector<double> cdf_;                 // cdf_[i] = 삼각형 0..i 면적 합 / 전체
+    std::vector<double> alias_prob_;          // Vose alias table
+    std::vector<std::uint32_t> alias_;
+    double total_area_ = 0.0;
+    std::uint64_t version_ = 0;
+};
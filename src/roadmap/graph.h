@@ -3,18 +3,28 @@
 #include <vector>
 #include "env/obstacle.h"  // for Vec2
 
-struct RoadmapNode {
+// 좌표와 edge weight 의 scalar 타입별 roadmap
+// (planner 는 double 로 만들고, build_path --precision=float 은 파일에서 바로 float 으로 읽는다)
+template <class T>
+struct RoadmapNodeT {
     int id;
-    Vec2 p;
+    Vec2T<T> p;
 };
 
-struct RoadmapEdge {
+template <class T>
+struct RoadmapEdgeT {
     int u;
     int v;
-    double w;
+    T w;
 };
 
-struct Graph {
-    std::vector<RoadmapNode> nodes;
-    std::vector<RoadmapEdge> edges;
+template <class T>
+struct GraphT {
+    std::vector<RoadmapNodeT<T>> nodes;
+    std::vector<RoadmapEdgeT<T>> edges;
 };
+
+using RoadmapNode = RoadmapNodeT<double>;
+using RoadmapEdge = RoadmapEdgeT<double>;
+using Graph  = GraphT<double>;
+using GraphF = GraphT<float>;
@@ -0,0 +1,137 @@
+// /src/roadmap/kdtree.cc
+#include "roadmap/kdtree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace {
+    double coord(const Vec2 &p, int dim) { return dim == 0 ? p.x : p.y; }
+}
+
+void KdTree::build(const std::vector<Vec2> &pts) {
+    nodes_.clear();
+    idx_.resize(pts.size());
+    std::iota(idx_.begin(), idx_.end(), 0);
+    pts_ = pts;
+    if (pts_.empty())
+        return;
+    nodes_.reserve(2 * (pts_.size() / kLeafSize) + 1);
+    buildNode(0, static_cast<int>(pts_.size()));
+
+    // idx_ 순서로 좌표를 다시 모은다 (buildNode 는 idx_ 만 섞는다)
+    for (std::size_t i = 0; i < idx_.size(); ++i)
+        pts_[i] = pts[idx_[i]];
+}
+
+int KdTree::buildNode(int lo, int hi) {
+    const int id = static_cast<int>(nodes_.size());
+    nodes_.push_back({lo, hi});
+    if (hi - lo <= kLeafSize)
+        return id;
+
+    double minx = pts_[idx_[lo]].x, maxx = minx, miny = pts_[idx_[lo]].y, maxy = miny;
+    for (int i = lo + 1; i < hi; ++i) {
+        const Vec2 &p = pts_[idx_[i]];
+        minx = std::min(minx, p.x);
+        maxx = std::max(maxx, p.x);
+        miny = std::min(miny, p.y);
+        maxy = std::max(maxy, p.y);
+    }
+    const int dim = (maxx - minx >= maxy - miny) ? 0 : 1;
+    const int mid = lo + (hi - lo) / 2;
+    std::nth_element(idx_.begin() + lo, idx_.begin() + mid, idx_.begin() + hi, [&](int a, int b) {
+        return coord(pts_[a], dim) < coord(pts_[b], dim);
+    });
+    // 자식을 만들면 구간 안의 순서가 또 바뀌므로 split 은 먼저 읽어 둔다
+    const double split = coord(pts_[idx_[mid]], dim);
+
+    const int left = buildNode(lo, mid);
+    const int right = buildNode(mid, hi);
+    Node &n = nodes_[id];
+    n.dim = dim;
+    n.split = split;
+    n.left = left;
+    n.right = right;
+    return id;
+}
+
+void KdTree::radius(const Vec2 &q, double r, std::vector<int> &out) const {
+    if (nodes_.empty())
+        return;
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node &n = nodes_[stack[--top]];
+        if (n.left < 0) {
+            for (int i = n.lo; i < n.hi; ++i) {
+                const double dx = pts_[i].x - q.x;
+                const double dy = pts_[i].y - q.y;
+                if (std::sqrt(dx * dx + dy * dy) <= r)
+                    out.push_back(idx_[i]);
+            }
+            continue;
+        }
+        const double d = coord(q, n.dim) - n.split;
+        if (d - r <= 0.0)
+            stack[top++] = n.left;
+        if (d + r >= 0.0)
+            stack[top++] = n.right;
+    }
+}
+
+void KdTree::nearest(const Vec2 &q, std::size_t k, std::vector<int> &out) const {
+    out.clear();
+    if (nodes_.empty() || k == 0)
+        return;
+
+    // (거리^2, index) 의 max-heap. top 이 지금까지 k 개 중 가장 먼 것
+    using Item = std::pair<double, int>;
+    std::priority_queue<Item> best;
+    auto worst = [&]() {
+        return best.size() < k ? std::numeric_limits<double>::infinity() : best.top().first;
+    };
+
+    // 가까운 쪽 자식부터 내려가고, 먼 쪽은 분할선까지의 거리로 가지치기
+    struct Pending {
+        int node;
+        double plane_d2;  // 분할선까지 거리^2 (하한)
+    };
+    Pending stack[64];
+    int top = 0;
+    stack[top++] = {0, 0.0};
+    while (top > 0) {
+        const Pending cur = stack[--top];
+        if (cur.plane_d2 > worst())
+            continue;
+        const Node &n = nodes_[cur.node];
+        if (n.left < 0) {
+            for (int i = n.lo; i < n.hi; ++i) {
+                const double dx = pts_[i].x - q.x;
+                const double dy = pts_[i].y - q.y;
+                const Item item(dx * dx + dy * dy, idx_[i]);
+                if (best.size() < k) {
+                    best.push(item);
+                } else if (item < best.top()) {
+                    best.pop();
+                    best.push(item);
+                }
+            }
+            continue;
+        }
+        const double d = coord(q, n.dim) - n.split;
+        const int near_child = d <= 0.0 ? n.left : n.right;
+        const int far_child = d <= 0.0 ? n.right : n.left;
+        stack[top++] = {far_child, std::max(cur.plane_d2, d * d)};
+        stack[top++] = {near_child, cur.plane_d2};
+    }
+
+    out.resize(best.size());
+    for (std::size_t i = best.size(); i-- > 0;) {
+        out[i] = best.top().second;
+        best.pop();
+    }
+}
@@ -0,0 +1,43 @@
+// /src/roadmap/kdtree.h
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "env/vec2.h"
+
+// 2D 점들의 정적 k-d tree (한 번 build 하고 여러 번 query)
+// - 점 좌표를 tree 순서로 복사해 두고, 각 node 는 그 배열의 연속 구간이라 leaf 는 순차 scan 이다
+// - 구간의 bbox 가 긴 축의 median 으로 나눈다 (중복 점/한쪽으로 몰린 분포에서도 깊이 O(log n))
+// - 결과는 build 에 준 vector 의 index
+class KdTree {
+public:
+    static constexpr int kLeafSize = 8;
+
+    KdTree() = default;
+    explicit KdTree(const std::vector<Vec2> &pts) { build(pts); }
+
+    void build(const std::vector<Vec2> &pts);
+
+    std::size_t size() const { return pts_.size(); }
+    bool empty() const { return pts_.empty(); }
+
+    // q 에서 거리 r 이하 (sqrt(dx^2 + dy^2) <= r) 인 점들의 index 를 out 에 덧붙인다 (순서 없음)
+    void radius(const Vec2 &q, double r, std::vector<int> &out) const;
+
+    // q 에서 가까운 순서로 최대 k 개의 index 를 out 에 (거리가 같으면 index 가 작은 것 먼저)
+    void nearest(const Vec2 &q, std::size_t k, std::vector<int> &out) const;
+
+private:
+    struct Node {
+        int lo, hi;          // pts_ 의 구간 [lo, hi)
+        int left = -1;       // 자식 node (leaf 면 -1)
+        int right = -1;
+        int dim = 0;         // 0: x, 1: y
+        double split = 0.0;  // 왼쪽 구간은 split 이하, 오른쪽은 split 이상
+    };
+
+    int buildNode(int lo, int hi);
+
+    std::vector<Node> nodes_;
+    std::vector<Vec2> pts_;  // tree 순서
+    std::vector<int> idx_;   // pts_[i] 의 원래 index
+};
@@ -1,10 +1,15 @@
 // /src/roadmap/prm.cc
 #include "roadmap/prm.h"
+#include "roadmap/kdtree.h"
 #include "roadmap/sampling.h"
+#include "env/parallel.h"
+#include "env/rng.h"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <ostream>
 #include <iostream>
+#include <vector>
 
 
 SamplerType samplerFromString(const std::string &name) {
@@ -14,12 +19,31 @@ SamplerType samplerFromString(const std::string &name) {
         return SamplerType::HALTON;
     if (name == "prm_sobol")
         return SamplerType::SOBOL;
+    if (name == "prm_gaussian")
+        return SamplerType::GAUSSIAN;
+    if (name == "prm_bridge")
+        return SamplerType::BRIDGE;
+    if (name == "prm_medial")
+        return SamplerType::MEDIAL;
+    if (name == "prm_poisson")
+        return SamplerType::POISSON;
     throw std::runtime_error("Unknown PRM sampler: " + name);
 }
 
+namespace {
+    // 연결 단계에서 한 thread 가 한 번에 맡는 노드 수
+    constexpr int kPRMChunk = 64;
+}
+
 Graph buildPRM(const Environment &env, int n_samples,
                SamplerType sampler, double radius,
-               std::ostream *log) {
+               std::ostream *log,
+               const PRMOptions &opts) {
+    const FreeSpaceSampler *free_space = opts.free_space;
+    if (free_space && (free_space->empty() || free_space->version() != env.version()))
+        throw std::runtime_error("PRM: free space triangulation is empty or stale");
+    const double sigma = opts.narrow_sigma > 0.0 ? opts.narrow_sigma : 0.25 * radius;
+
     Graph g;
     g.nodes.clear();
     g.edges.clear();
@@ -43,42 +67,145 @@ Graph buildPRM(const Environment &env, int n_samples,
         if (log) *log << "EDGE " << u << " " << v << "\n";
     };
 
-    // 샘플링 루프
-    for (int i = 0; i < n_samples; ++i) {
-        Vec2 p;
-        if (sampler == SamplerType::RANDOM)
-            p = sampleUniformFree(env);
-        else if (sampler == SamplerType::HALTON)
-            p = sampleHaltonFree(env, static_cast<std::size_t>(i + 1));
-        else
-            p = sampleSobolFree(env, static_cast<std::size_t>(i + 1));
-
-        // 새 노드 id
-        int id = static_cast<int>(g.nodes.size());
-        // 일단 free 공간이니까 바로 추가 (충돌은 segment에서만 검사)
-        g.nodes.push_back({id, p});
-
-        begin_step();
-        log_node(id, p);
-
-        // 기존 모든 노드와 연결 시도
-        for (int j = 0; j < id; ++j) {
-            const Vec2 &a = g.nodes[j].p;
-            const Vec2 &b = p;
-            double dx = a.x - b.x;
-            double dy = a.y - b.y;
-            double dist = std::sqrt(dx * dx + dy * dy);
-            if (dist > radius)
-                continue;
-            if (!env.segmentFree(a, b))
-                continue;
-            g.edges.push_back({j, id, dist});
-            g.edges.push_back({id, j, dist});
-            log_edge(j, id);
+    const int threads = resolveThreadCount(opts.threads);
+    const std::size_t n = static_cast<std::size_t>(std::max(0, n_samples));
+
+    // 1) 샘플을 먼저 모두 뽑는다. 샘플 i 는 호출한 thread 의 stream 의 substream(i) 에서
+    //    뽑으므로 어느 thread 가 만들든 같다. 한 점열을 rejection 하며 이어 쓰는 RANDOM / SOBOL 은
+    //    block 단위로 병렬로 만들고 순서대로 이어 붙인다. POISSON 은 점 집합 전체가 순차적이다
+    const RandomStream base = RNG::stream();
+    // SOBOL 은 점열 하나를 순서대로 쓴다. scramble 은 roadmap 종류와 상관없이 env seed 에서
+    const SobolSequence sobol(2, RandomStream(base.seed(), rng_stream::forName("sobol")),
+                              opts.sobol_scramble);
+    std::vector<Vec2> samples;
+    samples.reserve(n);
+    if (sampler == SamplerType::RANDOM && !free_space) {
+        BatchFreeSampler uniform_free(env, base);
+        uniform_free.take(n, samples, threads);
+    } else if (sampler == SamplerType::SOBOL && !free_space) {
+        SobolSequence seq = sobol;
+        takeSobolFree(env, seq, n, samples, threads);
+    } else if (sampler == SamplerType::POISSON) {
+        const double spacing = opts.poisson_spacing > 0.0 ? opts.poisson_spacing : 0.5 * radius;
+        RandomStream poisson_rng = base;
+        samples = samplePoissonDiskFree(env, spacing, poisson_rng, n, free_space);
+    } else {
+        samples.resize(n);
+        parallelFor(0, static_cast<int>(n), [&](int i) {
+            RandomStream rng = base.substream(static_cast<std::uint32_t>(i));
+            Vec2 p;
+            switch (sampler) {
+            case SamplerType::RANDOM:
+                p = free_space->sample(rng);
+                break;
+            case SamplerType::HALTON:
+                p = free_space ? sampleHaltonFree(*free_space, static_cast<std::size_t>(i + 1))
+                               : sampleHaltonFree(env, static_cast<std::size_t>(i + 1), rng);
+                break;
+            case SamplerType::SOBOL: {
+                double u[SobolSequence::kMaxDims];
+                sobol.point(static_cast<std::uint64_t>(i), u);
+                p = free_space->map(u[0], u[1]);
+                break;
+            }
+            // GAUSSIAN/BRIDGE 는 막힌 점도 뽑아야 하므로 삼각분할과 상관없이 world 에서
+            case SamplerType::GAUSSIAN:
+                p = sampleGaussianFree(env, sigma, rng);
+                break;
+            case SamplerType::BRIDGE:
+                p = sampleBridgeFree(env, sigma, rng);
+                break;
+            case SamplerType::MEDIAL:
+                p = free_space ? retractToMedialAxis(env, free_space->sample(rng), sigma)
+                               : sampleMedialFree(env, sigma, rng);
+                break;
+            case SamplerType::POISSON:
+                break;
+            }
+            samples[static_cast<std::size_t>(i)] = p;
+        }, threads);
+    }
+
+    // 일단 free 공간이니까 바로 추가 (충돌은 segment에서만 검사)
+    for (const Vec2 &p : samples)
+        g.nodes.push_back({static_cast<int>(g.nodes.size()), p});
+
+    // 2) 전체 노드 위의 k-d tree. 노드 id 는 그 노드보다 앞의 노드들과만 연결한다
+    std::vector<Vec2> points;
+    points.reserve(g.nodes.size());
+    for (const RoadmapNode &nd : g.nodes)
+        points.push_back(nd.p);
+    const KdTree tree(points);
+
+    // 3) 연속한 노드 묶음 (chunk) 마다 이웃 찾기와 edge 충돌 검사를 한 thread 가 맡아
+    //    자기 buffer 에 (id, j) 순서로 쌓는다. chunk 순서대로 이어 붙이면 thread 수와 상관없이
+    //    순차로 만든 것과 같은 순서가 된다
+    struct ChunkEdges {
+        std::vector<RoadmapEdge> edges;    // {j, id, dist}, id 그리고 j 순서
+        std::vector<std::size_t> end;      // chunk 안 k 번째 노드의 edge 가 끝나는 위치
+    };
+    const int first_id = 2;
+    const int n_nodes = static_cast<int>(g.nodes.size());
+    const int n_chunks = (n_nodes - first_id + kPRMChunk - 1) / kPRMChunk;
+    std::vector<ChunkEdges> chunks(static_cast<std::size_t>(std::max(0, n_chunks)));
+    parallelFor(0, n_chunks, [&](int c) {
+        ChunkEdges &out = chunks[c];
+        std::vector<int> near;
+        std::vector<int> cand_ids;
+        std::vector<double> cand_dist;
+        std::vector<Segment> cand_segs;
+        const int id0 = first_id + c * kPRMChunk;
+        const int id1 = std::min(n_nodes, id0 + kPRMChunk);
+        for (int id = id0; id < id1; ++id) {
+            const Vec2 &p = g.nodes[id].p;
+
+            // radius 안의 노드 중 앞선 (id 가 작은) 것들을 id 순서로 후보로 모으고
+            cand_ids.clear();
+            cand_dist.clear();
+            cand_segs.clear();
+            near.clear();
+            tree.radius(p, radius, near);
+            std::sort(near.begin(), near.end());
+            for (int j : near) {
+                if (j >= id)
+                    break;
+                const Vec2 &a = g.nodes[j].p;
+                const Vec2 &b = p;
+                double dx = a.x - b.x;
+                double dy = a.y - b.y;
+                double dist = std::sqrt(dx * dx + dy * dy);
+                cand_ids.push_back(j);
+                cand_dist.push_back(dist);
+                cand_segs.emplace_back(a, b);
+            }
+
+            // 후보 edge 들을 한 번에 충돌 검사
+            FreeMask free_mask = env.segmentFreeBatch(cand_segs);
+            for (std::size_t k = 0; k < cand_ids.size(); ++k) {
+                if (free_mask.test(k))
+                    out.edges.push_back({cand_ids[k], id, cand_dist[k]});
+            }
+            out.end.push_back(out.edges.size());
         }
+    }, threads, /*chunk=*/1);
 
-        end_step();
-        ++step;
+    // 4) chunk 순서대로 합치면서 step 로그를 남긴다
+    for (int c = 0; c < n_chunks; ++c) {
+        const ChunkEdges &ce = chunks[c];
+        std::size_t e = 0;
+        for (std::size_t k = 0; k < ce.end.size(); ++k) {
+            const int id = first_id + c * kPRMChunk + static_cast<int>(k);
+            begin_step();
+            log_node(id, g.nodes[id].p);
+            for (; e < ce.end[k]; ++e) {
+                const RoadmapEdge &ed = ce.edges[e];
+                g.edges.push_back({ed.u, ed.v, ed.w});
+                g.edges.push_back({ed.v, ed.u, ed.w});
+                log_edge(ed.u, ed.v);
+            }
+            end_step();
+            ++step;
+        }
     }
 
     return g;
@@ -3,18 +3,39 @@
 #include <string>
 #include "roadmap/graph.h"
 #include "env/environment.h"
+#include "roadmap/free_space.h"
+#include "roadmap/sobol.h"
 #include <ostream>
 
 enum class SamplerType {
     RANDOM,
     HALTON,
-    SOBOL
+    SOBOL,
+    GAUSSIAN,  // obstacle 경계 근처
+    BRIDGE,    // 좁은 틈 (bridge test)
+    MEDIAL,    // medial axis 근처 (clearance 기울기를 따라 올라감)
+    POISSON    // Poisson-disk (점 사이 최소 간격 보장, n_samples 는 상한)
 };
 
 SamplerType samplerFromString(const std::string &name);
 
+// buildPRM 의 부가 설정
+struct PRMOptions {
+    // 주면 샘플을 rejection 대신 이 삼각분할에서 뽑는다 (env 와 같은 version 이어야 함)
+    const FreeSpaceSampler *free_space = nullptr;
+    // SOBOL: 점열 scrambling (seed 는 env seed 에서)
+    SobolScramble sobol_scramble = SobolScramble::OWEN;
+    // GAUSSIAN/BRIDGE 의 표준편차, MEDIAL 의 처음 보폭 (<= 0 이면 radius / 4)
+    double narrow_sigma = 0.0;
+    // POISSON 의 최소 점 간격 (<= 0 이면 radius / 2)
+    double poisson_spacing = 0.0;
+    // 샘플링 / 이웃 찾기 / edge 검사 thread 수 (0 이하면 전체 core). 결과 graph 는 thread 수와 무관
+    int threads = 1;
+};
+
 // Build a PRM graph with N samples and connection radius
 
 Graph buildPRM(const Environment &env, int n_samples,
                SamplerType sampler, double radius,
-               std::ostream *log = nullptr);
+               std::ostream *log = nullptr,
+               const PRMOptions &opts = PRMOptions());
@@ -37,12 +37,17 @@ Graph buildRRTGraph(const Environment &env,
 
     int goal_index = -1;
 
+    // 호출한 thread 의 stream 에서: goal bias 는 substream 0, free 샘플은 substream 1 부터 batch 로
+    const RandomStream base = RNG::stream();
+    RandomStream bias_rng = base.substream(0);
+    BatchFreeSampler uniform_free(env, base, /*first_substream=*/1);
+
     for (int iter = 0; iter < max_iter; ++iter) {
         Vec2 sample;
-        if (RNG::uniform(0.0, 1.0) < goal_bias)
+        if (bias_rng.uniform(0.0, 1.0) < goal_bias)
             sample = env.goal;
         else
-            sample = sampleUniformFree(env);
+            sample = uniform_free.next();
 
         // nearest
         int nearest = 0;
@@ -1,6 +1,7 @@
 // /src/roadmap/sampling.cpp
 #include "roadmap/sampling.h"
-#include "env/rng.h"
+#include "env/parallel.h"
+#include <algorithm>
 #include <cmath>
 
 double halton(int index, int base) {
@@ -15,33 +16,309 @@ double halton(int index, int base) {
     return r;
 }
 
-Vec2 sampleUniformFree(const Environment &env) {
+Vec2 sampleUniformFree(const Environment &env, RandomStream &rng) {
     while (true) {
-        double x = RNG::uniform(env.world_min, env.world_max);
-        double y = RNG::uniform(env.world_min, env.world_max);
+        double x = rng.uniform(env.world_min, env.world_max);
+        double y = rng.uniform(env.world_min, env.world_max);
         Vec2 p(x, y);
         if (env.isFree(p))
             return p;
     }
 }
 
-Vec2 sampleHaltonFree(const Environment &env, std::size_t idx) {
+BatchFreeSampler::BatchFreeSampler(const Environment &env, const RandomStream &base,
+                                   std::uint32_t first_substream, std::size_t block)
+    : env_(env), base_(base), next_substream_(first_substream), block_(block > 0 ? block : 1),
+      coords_(2 * block_), cand_(block_) {}
+
+void BatchFreeSampler::generateBlock(std::uint32_t substream, std::vector<double> &coords,
+                                     std::vector<Vec2> &cand, std::vector<Vec2> &out) const {
+    RandomStream rng = base_.substream(substream);
+    coords.resize(2 * block_);
+    cand.resize(block_);
+    rng.fillUniform(coords.data(), coords.size(), env_.world_min, env_.world_max);
+    for (std::size_t i = 0; i < block_; ++i)
+        cand[i] = Vec2(coords[2 * i], coords[2 * i + 1]);
+
+    FreeMask mask = env_.isFreeBatch(cand);
+    for (std::size_t i = 0; i < block_; ++i) {
+        if (mask.test(i))
+            out.push_back(cand[i]);
+    }
+}
+
+void BatchFreeSampler::refill() {
+    ready_.clear();
+    head_ = 0;
+    // 전부 막힌 block 이면 free 점이 나올 때까지 다음 block
+    while (ready_.empty()) {
+        generateBlock(next_substream_++, coords_, cand_, ready_);
+        candidates_ += block_;
+        accepted_ += ready_.size();
+    }
+}
+
+Vec2 BatchFreeSampler::next() {
+    if (head_ == ready_.size())
+        refill();
+    return ready_[head_++];
+}
+
+void BatchFreeSampler::take(std::size_t n, std::vector<Vec2> &out, int threads) {
+    for (; n > 0 && head_ < ready_.size(); --n)
+        out.push_back(ready_[head_++]);
+    if (n == 0)
+        return;
+    ready_.clear();
+    head_ = 0;
+
+    const int n_threads = resolveThreadCount(threads);
+    std::vector<std::vector<Vec2>> blocks(static_cast<std::size_t>(n_threads));
+    while (n > 0) {
+        const std::uint32_t first = next_substream_;
+        parallelFor(0, n_threads, [&](int t) {
+            std::vector<double> coords;
+            std::vector<Vec2> cand;
+            blocks[t].clear();
+            generateBlock(first + static_cast<std::uint32_t>(t), coords, cand, blocks[t]);
+        }, n_threads, /*chunk=*/1);
+        next_substream_ += static_cast<std::uint32_t>(n_threads);
+        candidates_ += static_cast<std::uint64_t>(n_threads) * block_;
+
+        for (const std::vector<Vec2> &b : blocks) {
+            accepted_ += b.size();
+            for (const Vec2 &p : b) {
+                if (n > 0) {
+                    out.push_back(p);
+                    --n;
+                } else {
+                    ready_.push_back(p);
+                }
+            }
+        }
+    }
+}
+
+Vec2 sampleHaltonFree(const Environment &env, std::size_t idx, RandomStream &rng) {
     double hx = halton(static_cast<int>(idx), 2);
     double hy = halton(static_cast<int>(idx), 3);
     Vec2 p(env.world_min + (env.world_max - env.world_min) * hx,
            env.world_min + (env.world_max - env.world_min) * hy);
     if (!env.isFree(p))
-        return sampleUniformFree(env);
+        return sampleUniformFree(env, rng);
     return p;
 }
 
-Vec2 sampleSobolFree(const Environment &env, std::size_t idx) {
-    // very rough Sobol-like using different Halton bases
-    double sx = halton(static_cast<int>(idx), 5);
-    double sy = halton(static_cast<int>(idx), 7);
-    Vec2 p(env.world_min + (env.world_max - env.world_min) * sx,
-           env.world_min + (env.world_max - env.world_min) * sy);
-    if (!env.isFree(p))
-        return sampleUniformFree(env);
-    return p;
+Vec2 sampleSobolFree(const Environment &env, SobolSequence &seq) {
+    double u[SobolSequence::kMaxDims];
+    while (true) {
+        seq.next(u);
+        Vec2 p(env.world_min + (env.world_max - env.world_min) * u[0],
+               env.world_min + (env.world_max - env.world_min) * u[1]);
+        if (env.isFree(p))
+            return p;
+    }
+}
+
+void takeSobolFree(const Environment &env, SobolSequence &seq, std::size_t n,
+                   std::vector<Vec2> &out, int threads) {
+    constexpr std::size_t kBlock = 256;
+    const int n_threads = resolveThreadCount(threads);
+    const double lo = env.world_min, span = env.world_max - env.world_min;
+
+    // block t 의 free 점과 그 점열 index
+    struct Block {
+        std::vector<Vec2> pts;
+        std::vector<std::uint64_t> index;
+    };
+    std::vector<Block> blocks(static_cast<std::size_t>(n_threads));
+    std::uint64_t first = seq.index();
+    std::uint64_t next_index = first;  // 마지막으로 쓴 점 다음
+    while (n > 0) {
+        parallelFor(0, n_threads, [&](int t) {
+            Block &b = blocks[t];
+            b.pts.clear();
+            b.index.clear();
+            std::vector<Vec2> cand(kBlock);
+            const std::uint64_t i0 = first + static_cast<std::uint64_t>(t) * kBlock;
+            double u[SobolSequence::kMaxDims];
+            for (std::size_t i = 0; i < kBlock; ++i) {
+                seq.point(i0 + i, u);
+                cand[i] = Vec2(lo + span * u[0], lo + span * u[1]);
+            }
+            FreeMask mask = env.isFreeBatch(cand);
+            for (std::size_t i = 0; i < kBlock; ++i) {
+                if (!mask.test(i))
+                    continue;
+                b.pts.push_back(cand[i]);
+                b.index.push_back(i0 + i);
+            }
+        }, n_threads, /*chunk=*/1);
+        first += static_cast<std::uint64_t>(n_threads) * kBlock;
+
+        for (const Block &b : blocks) {
+            for (std::size_t k = 0; k < b.pts.size() && n > 0; ++k, --n) {
+                out.push_back(b.pts[k]);
+                next_index = b.index[k] + 1;
+            }
+        }
+    }
+    seq.seek(next_index);
+}
+
+Vec2 sampleHaltonFree(const FreeSpaceSampler &fs, std::size_t idx) {
+    return fs.map(halton(static_cast<int>(idx), 2), halton(static_cast<int>(idx), 3));
+}
+
+Vec2 sampleSobolFree(const FreeSpaceSampler &fs, SobolSequence &seq) {
+    double u[SobolSequence::kMaxDims];
+    seq.next(u);
+    return fs.map(u[0], u[1]);
+}
+
+Vec2 sampleGaussianFree(const Environment &env, double sigma, RandomStream &rng, int attempts) {
+    for (int k = 0; k < attempts; ++k) {
+        Vec2 q1(rng.uniform(env.world_min, env.world_max), rng.uniform(env.world_min, env.world_max));
+        Vec2 q2(q1.x + rng.normal(0.0, sigma), q1.y + rng.normal(0.0, sigma));
+        const bool f1 = env.isFree(q1);
+        const bool f2 = env.isFree(q2);
+        if (f1 != f2)
+            return f1 ? q1 : q2;
+    }
+    return sampleUniformFree(env, rng);
+}
+
+Vec2 sampleBridgeFree(const Environment &env, double sigma, RandomStream &rng, int attempts) {
+    for (int k = 0; k < attempts; ++k) {
+        Vec2 q1(rng.uniform(env.world_min, env.world_max), rng.uniform(env.world_min, env.world_max));
+        Vec2 q2(q1.x + rng.normal(0.0, sigma), q1.y + rng.normal(0.0, sigma));
+        if (env.isFree(q1) || env.isFree(q2))
+            continue;
+        Vec2 m(0.5 * (q1.x + q2.x), 0.5 * (q1.y + q2.y));
+        if (env.isFree(m))
+            return m;
+    }
+    return sampleUniformFree(env, rng);
+}
+
+namespace {
+    // obstacle edge 와 (robot radius 만큼 줄어든) world 경계 중 가까운 쪽까지의 거리
+    double freeClearance(const Environment &env, const Vec2 &p) {
+        const double lo = env.world_min + env.robotRadius();
+        const double hi = env.world_max - env.robotRadius();
+        const double wall = std::min(std::min(p.x - lo, hi - p.x), std::min(p.y - lo, hi - p.y));
+        return std::min(wall, env.clearance(p));
+    }
+}
+
+Vec2 retractToMedialAxis(const Environment &env, Vec2 p, double step) {
+    const double c = freeClearance(env, p);
+    if (!(c > 0.0) || !(step > 0.0))
+        return p;
+
+    // medial axis 밖에서 clearance 의 기울기는 가장 가까운 점에서 p 로 향하는 단위 벡터
+    const double h = 1e-3 * std::min(step, c);
+    const double gx = freeClearance(env, Vec2(p.x + h, p.y)) - freeClearance(env, Vec2(p.x - h, p.y));
+    const double gy = freeClearance(env, Vec2(p.x, p.y + h)) - freeClearance(env, Vec2(p.x, p.y - h));
+    const double gn = std::sqrt(gx * gx + gy * gy);
+    if (gn <= 0.0)
+        return p;  // 이미 medial axis 위
+    const Vec2 d(gx / gn, gy / gn);
+
+    // 그 방향으로 가는 동안 가장 가까운 점이 그대로면 clearance 가 이동 거리만큼 늘어난다.
+    // 다른 feature 가 더 가까워지는 첫 지점 (medial axis) 을 step 을 두 배씩 늘려 넘긴 뒤 이분 탐색
+    // clearance(p + t d) >= c + t 이면 반지름 c + t 원이 p 와 그 사이 선분을 덮으므로 그 점은 free
+    const double tol = 1e-9 * (env.world_max - env.world_min);
+    auto stillNearest = [&](double t) {
+        return freeClearance(env, Vec2(p.x + t * d.x, p.y + t * d.y)) >= c + t - tol;
+    };
+    const double max_t = env.world_max - env.world_min;
+    double lo = 0.0, hi = step;
+    while (hi < max_t && stillNearest(hi)) {
+        lo = hi;
+        hi *= 2.0;
+    }
+    const double resolution = step / 64.0;
+    while (hi - lo > resolution) {
+        const double mid = 0.5 * (lo + hi);
+        if (stillNearest(mid))
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return Vec2(p.x + lo * d.x, p.y + lo * d.y);
+}
+
+Vec2 sampleMedialFree(const Environment &env, double step, RandomStream &rng) {
+    return retractToMedialAxis(env, sampleUniformFree(env, rng), step);
+}
+
+std::vector<Vec2> samplePoissonDiskFree(const Environment &env, double spacing, RandomStream &rng,
+                                        std::size_t max_points, const FreeSpaceSampler *fs, int k) {
+    std::vector<Vec2> pts;
+    if (!(spacing > 0.0) || max_points == 0)
+        return pts;
+
+    constexpr double kTwoPi = 6.283185307179586;
+    const double lo = env.world_min;
+    const double cell = spacing / std::sqrt(2.0);
+    const int n = std::max(1, static_cast<int>(std::ceil((env.world_max - env.world_min) / cell)));
+    std::vector<int> grid(static_cast<std::size_t>(n) * n, -1);  // cell 의 점 index
+    auto cellOf = [&](double v) {
+        return std::clamp(static_cast<int>((v - lo) / cell), 0, n - 1);
+    };
+    auto farEnough = [&](const Vec2 &p) {
+        const int cx = cellOf(p.x), cy = cellOf(p.y);
+        for (int y = std::max(0, cy - 2); y <= std::min(n - 1, cy + 2); ++y) {
+            for (int x = std::max(0, cx - 2); x <= std::min(n - 1, cx + 2); ++x) {
+                const int j = grid[static_cast<std::size_t>(y) * n + x];
+                if (j < 0)
+                    continue;
+                const double dx = pts[j].x - p.x, dy = pts[j].y - p.y;
+                if (dx * dx + dy * dy < spacing * spacing)
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<int> active;
+    auto add = [&](const Vec2 &p) {
+        grid[static_cast<std::size_t>(cellOf(p.y)) * n + cellOf(p.x)] = static_cast<int>(pts.size());
+        active.push_back(static_cast<int>(pts.size()));
+        pts.push_back(p);
+    };
+
+    int failed_seeds = 0;
+    while (pts.size() < max_points && failed_seeds < kPoissonReseedAttempts) {
+        const Vec2 seed = fs ? fs->sample(rng) : sampleUniformFree(env, rng);
+        if (!farEnough(seed)) {
+            ++failed_seeds;
+            continue;
+        }
+        failed_seeds = 0;
+        add(seed);
+
+        while (!active.empty() && pts.size() < max_points) {
+            const std::size_t a = static_cast<std::size_t>(rng.uniformInt(0, static_cast<int>(active.size()) - 1));
+            const Vec2 center = pts[active[a]];
+            bool found = false;
+            for (int t = 0; t < k; ++t) {
+                // 원환 면적에 대해 uniform: 반지름^2 이 [r^2, 4 r^2] 에서 uniform
+                const double rad = spacing * std::sqrt(1.0 + 3.0 * rng.uniform());
+                const double ang = kTwoPi * rng.uniform();
+                const Vec2 q(center.x + rad * std::cos(ang), center.y + rad * std::sin(ang));
+                if (!env.isFree(q) || !farEnough(q))
+                    continue;
+                add(q);
+                found = true;
+                break;
+            }
+            if (!found) {
+                active[a] = active.back();
+                active.pop_back();
+            }
+        }
+    }
+    return pts;
 }
@@ -1,15 +1,109 @@
 // /src/roadmap/sampling.h
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "env/environment.h"
+#include "env/rng.h"
+#include "roadmap/free_space.h"
+#include "roadmap/sobol.h"
 
 double halton(int index, int base);
 
-// Uniform random free-space sample
-Vec2 sampleUniformFree(const Environment &env);
+// Uniform random free-space sample (rejection, rng 에서 뽑는다)
+// 병렬/재현성: 샘플 i 마다 base.substream(i) 를 넘기면 thread 배치와 상관없이 같은 점
+Vec2 sampleUniformFree(const Environment &env, RandomStream &rng);
 
-// 2D Halton-based low-discrepancy sample
-Vec2 sampleHaltonFree(const Environment &env, std::size_t idx);
+// uniform free-space sample 을 block 단위로 만들어 쌓아 두는 sampler
+// - block b 의 후보 block_size 개는 base.substream(first_substream + b) 에서 fillUniform 으로 한 번에 뽑고
+//   isFreeBatch 로 한 번에 거른다 (점마다 rejection loop 를 돌지 않는다)
+// - next() 가 돌려주는 순서는 base 로만 정해진다 (block 을 어느 thread 가 만들든 같다)
+// - sampleUniformFree 처럼 free 공간이 없으면 끝나지 않는다
+class BatchFreeSampler {
+public:
+    static constexpr std::size_t kDefaultBlock = 256;
 
-// Simple Sobol-like sample (using different Halton bases)
-Vec2 sampleSobolFree(const Environment &env, std::size_t idx);
+    BatchFreeSampler(const Environment &env, const RandomStream &base,
+                     std::uint32_t first_substream = 0, std::size_t block = kDefaultBlock);
+
+    Vec2 next();
+
+    // next() 를 n 번 부른 것과 같은 점들을 out 에 덧붙인다
+    // 모자란 block 들은 threads 개씩 병렬로 만들고 block 순서대로 이어 붙인다 (남은 점은 다음에 쓴다)
+    void take(std::size_t n, std::vector<Vec2> &out, int threads = 1);
+
+    std::uint64_t candidates() const { return candidates_; }  // 지금까지 만든 후보 수
+    std::uint64_t accepted() const { return accepted_; }      // 그 중 free 였던 수
+
+private:
+    // substream 의 block 하나를 만들어 free 인 점을 out 에 덧붙인다 (여러 thread 에서 불러도 된다)
+    void generateBlock(std::uint32_t substream, std::vector<double> &coords,
+                       std::vector<Vec2> &cand, std::vector<Vec2> &out) const;
+    void refill();
+
+    const Environment &env_;
+    RandomStream base_;
+    std::uint32_t next_substream_;
+    std::size_t block_;
+
+    std::vector<Vec2> ready_;  // [head_, size) 가 아직 안 쓴 샘플 (만든 순서)
+    std::size_t head_ = 0;
+
+    std::vector<double> coords_;  // 후보의 x, y 를 번갈아
+    std::vector<Vec2> cand_;
+    std::uint64_t candidates_ = 0;
+    std::uint64_t accepted_ = 0;
+};
+
+// 2D Halton-based low-discrepancy sample (점이 막혀 있으면 rng 로 uniform fallback)
+Vec2 sampleHaltonFree(const Environment &env, std::size_t idx, RandomStream &rng);
+
+// 2D Sobol sample: 막힌 점은 버리고 seq 의 다음 점을 쓴다 (free 공간 안에서 점열 순서를 유지)
+// seq 는 2 차원 이상이어야 하고 앞 두 차원을 쓴다
+Vec2 sampleSobolFree(const Environment &env, SobolSequence &seq);
+
+// sampleSobolFree 를 n 번 부른 것과 같은 점들을 out 에 덧붙이고 seq 도 같은 위치로 옮긴다
+// 점열을 block 단위로 나눠 threads 개씩 병렬로 점을 계산하고 isFreeBatch 로 거른 뒤 순서대로 이어 붙인다
+void takeSobolFree(const Environment &env, SobolSequence &seq, std::size_t n,
+                   std::vector<Vec2> &out, int threads = 1);
+
+// 같은 low-discrepancy 점을 world 대신 free space 삼각분할로 옮긴다 (막힌 점도 fallback 도 없다)
+// 면적은 보존하지만 삼각형 사이의 고른 분포는 보장되지 않는다 (FreeSpaceSampler::map)
+Vec2 sampleHaltonFree(const FreeSpaceSampler &fs, std::size_t idx);
+Vec2 sampleSobolFree(const FreeSpaceSampler &fs, SobolSequence &seq);
+
+// narrow passage 쪽으로 치우친 sampler 들 (obstacle 이 없거나 드물어서 attempts 번 안에
+// 조건을 만족하는 점이 안 나오면 uniform free sample 로 대신한다)
+constexpr int kNarrowSampleAttempts = 100;
+
+// Gaussian (Boor et al. 1999): q1 은 world uniform, q2 = q1 + N(0, sigma^2) 에서
+// 둘 중 하나만 free 면 그 점 → obstacle 경계 근처에 몰린다
+Vec2 sampleGaussianFree(const Environment &env, double sigma, RandomStream &rng,
+                        int attempts = kNarrowSampleAttempts);
+
+// bridge test (Hsu et al. 2003): q1, q2 = q1 + N(0, sigma^2) 이 둘 다 막혀 있고
+// 가운데 점이 free 면 그 점 → 두 obstacle 사이의 좁은 틈에 몰린다
+Vec2 sampleBridgeFree(const Environment &env, double sigma, RandomStream &rng,
+                      int attempts = kNarrowSampleAttempts);
+
+// free 점 p 를 가장 가까운 obstacle edge / world 경계 점에서 곧장 멀어지는 방향으로 옮겨
+// 다른 feature 와 거리가 같아지는 곳 (medial axis) 에 놓는다 (Wilmarth et al. 1999 의 retraction)
+// 방향은 clearance 의 수치 기울기로 정하고, 위치는 step / 64 까지 이분 탐색. 결과는 항상 free
+Vec2 retractToMedialAxis(const Environment &env, Vec2 p, double step);
+
+// medial axis sampler: uniform free 점을 retractToMedialAxis 로 옮긴다
+Vec2 sampleMedialFree(const Environment &env, double step, RandomStream &rng);
+
+// Poisson-disk (blue noise) sampler (Bridson 2007)
+// - 어떤 두 점도 spacing 보다 가깝지 않고, 더 넣을 자리가 없을 때까지 (또는 max_points 개까지) 채운다
+// - 점 주변 [spacing, 2 spacing] 원환에서 후보를 k 개 뽑아 보고, 못 찾으면 그 점을 active 에서 뺀다
+// - 가까운 점 검사는 한 변 spacing / sqrt(2) 인 background grid (cell 당 점 하나) 로 주변 5x5 cell 만
+// - active 가 비면 free space 의 다른 조각 (obstacle 로 막힌 곳) 을 위해 uniform free 점으로 다시 시작하고,
+//   kPoissonReseedAttempts 번 연속 기존 점과 너무 가까우면 끝낸다
+// - fs 를 주면 시작 / 재시작 점을 rejection 없이 그 삼각분할에서 뽑는다
+// max_points 를 채워 일찍 끝나면 앞쪽 (처음 시작점 주변) 부터 채워진 상태이다
+constexpr int kPoissonCandidates = 30;
+constexpr int kPoissonReseedAttempts = 64;
+std::vector<Vec2> samplePoissonDiskFree(const Environment &env, double spacing, RandomStream &rng,
+                                        std::size_t max_points, const FreeSpaceSampler *fs = nullptr,
+                                        int k = kPoissonCandidates);
@@ -0,0 +1,142 @@
+// /src/roadmap/sobol.cc
+#include "roadmap/sobol.h"
+#include <stdexcept>
+
+namespace {
+    // new-joe-kuo-6.21201 의 앞 차원들 (1 차원은 van der Corput 이라 표에 없다)
+    struct Primitive {
+        unsigned s;       // 원시 다항식 차수
+        unsigned a;       // 가운데 계수 bit
+        unsigned m[5];    // 초기 direction number
+    };
+    constexpr Primitive kJoeKuo[SobolSequence::kMaxDims - 1] = {
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+    };
+
+    std::uint32_t reverseBits(std::uint32_t x) {
+        x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+        x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+        x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+        x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    // Laine-Karras 식 permutation: 각 bit 가 자기보다 아래 bit 에만 영향을 준다
+    // bit 를 뒤집어서 적용하면 위 bit 가 아래 bit 를 섞는 nested uniform scrambling 이 된다
+    std::uint32_t laineKarras(std::uint32_t x, std::uint32_t seed) {
+        x += seed;
+        x ^= x * 0x6c50b47cu;
+        x ^= x * 0xb82f1e52u;
+        x ^= x * 0xc7afe638u;
+        x ^= x * 0x8d22f6e6u;
+        return x;
+    }
+
+    int lowestZeroBit(std::uint64_t n) {
+        int c = 0;
+        while (n & 1) {
+            n >>= 1;
+            ++c;
+        }
+        return c;
+    }
+
+    // Gray code g = n ^ (n >> 1) 의 bit 마다 direction number 를 XOR
+    std::uint32_t grayPoint(const std::uint32_t *v, std::uint64_t index) {
+        const std::uint64_t g = index ^ (index >> 1);
+        std::uint32_t x = 0;
+        for (int k = 0; k < SobolSequence::kBits; ++k) {
+            if ((g >> k) & 1u)
+                x ^= v[k];
+        }
+        return x;
+    }
+
+    constexpr double kInv32 = 1.0 / 4294967296.0;
+}
+
+SobolScramble sobolScrambleFromString(const std::string &name) {
+    if (name == "none")
+        return SobolScramble::NONE;
+    if (name == "digit")
+        return SobolScramble::DIGIT;
+    if (name == "owen")
+        return SobolScramble::OWEN;
+    throw std::runtime_error("Unknown Sobol scrambling: " + name);
+}
+
+SobolSequence::SobolSequence(unsigned dims, RandomStream rng, SobolScramble scramble)
+    : dims_(dims), scramble_(scramble) {
+    if (dims == 0 || dims > kMaxDims)
+        throw std::runtime_error("SobolSequence: dims must be in [1, " + std::to_string(kMaxDims) + "]");
+
+    for (int k = 0; k < kBits; ++k)
+        v_[0][k] = 1u << (kBits - 1 - k);
+
+    for (unsigned d = 1; d < dims_; ++d) {
+        const Primitive &p = kJoeKuo[d - 1];
+        std::uint32_t *v = v_[d];
+        for (unsigned k = 0; k < p.s; ++k)
+            v[k] = p.m[k] << (kBits - 1 - k);
+        for (unsigned k = p.s; k < static_cast<unsigned>(kBits); ++k) {
+            v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+            for (unsigned i = 1; i < p.s; ++i) {
+                if ((p.a >> (p.s - 1 - i)) & 1u)
+                    v[k] ^= v[k - i];
+            }
+        }
+    }
+
+    for (unsigned d = 0; d < dims_; ++d)
+        seed_[d] = rng();
+    seek(0);
+}
+
+void SobolSequence::seek(std::uint64_t index) {
+    for (unsigned d = 0; d < dims_; ++d)
+        x_[d] = grayPoint(v_[d], index);
+    index_ = index;
+}
+
+void SobolSequence::point(std::uint64_t index, double *out) const {
+    for (unsigned d = 0; d < dims_; ++d)
+        out[d] = static_cast<double>(scramble(d, grayPoint(v_[d], index))) * kInv32;
+}
+
+std::uint32_t SobolSequence::scramble(unsigned d, std::uint32_t x) const {
+    switch (scramble_) {
+    case SobolScramble::NONE:
+        return x;
+    case SobolScramble::DIGIT:
+        return x ^ seed_[d];
+    case SobolScramble::OWEN:
+        return reverseBits(laineKarras(reverseBits(x), seed_[d]));
+    }
+    return x;
+}
+
+void SobolSequence::next(double *out) {
+    for (unsigned d = 0; d < dims_; ++d)
+        out[d] = static_cast<double>(scramble(d, x_[d])) * kInv32;
+
+    // 다음 Gray code 는 index 의 가장 낮은 0 bit 하나만 바뀐다
+    const int c = lowestZeroBit(index_);
+    if (c >= kBits)
+        throw std::runtime_error("SobolSequence: index exceeds 2^32 points");
+    for (unsigned d = 0; d < dims_; ++d)
+        x_[d] ^= v_[d][c];
+    ++index_;
+}
+
+void SobolSequence::fill(std::uint64_t first, std::size_t count, double *out) {
+    if (index_ != first)
+        seek(first);
+    for (std::size_t i = 0; i < count; ++i)
+        next(out + i * dims_);
+}
@@ -0,0 +1,56 @@
+// /src/roadmap/sobol.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "env/rng.h"
+
+// Sobol 점열의 scrambling 방식
+enum class SobolScramble {
+    NONE,   // 원래 Sobol (첫 점이 원점)
+    DIGIT,  // 차원마다 random XOR (digital shift)
+    OWEN    // nested uniform (Owen) scrambling, hash 기반 (Burley 2020)
+};
+
+SobolScramble sobolScrambleFromString(const std::string &name);
+
+// Sobol 점열 (Joe & Kuo 2008 direction number, 32 bit, 최대 kMaxDims 차원)
+// - next() 는 Gray-code 순서로 한 점에 차원마다 XOR 한 번 (O(1))
+// - seek(n) 은 n 번째 점으로 바로 간다 (O(32)). 병렬로 나눈 index 범위는 각자 seek 해서 채운다
+// - scrambling 은 생성한 점에 점마다 따로 적용하므로 어느 index 범위를 누가 만들든 같은 값
+// - OWEN 과 DIGIT 모두 (0, m, 2)-net 성질 (앞 2^m 점이 크기 2^-m 인 모든 elementary box 에
+//   하나씩) 을 유지한다
+class SobolSequence {
+public:
+    static constexpr unsigned kMaxDims = 8;
+    static constexpr int kBits = 32;
+
+    // scramble 용 차원별 seed 는 rng 에서 뽑는다 (env seed 의 stream 을 넘기면 env 마다 다른 scramble)
+    SobolSequence(unsigned dims, RandomStream rng, SobolScramble scramble = SobolScramble::OWEN);
+
+    unsigned dims() const { return dims_; }
+    std::uint64_t index() const { return index_; }  // 다음 next() 가 돌려줄 점의 index
+
+    // index 번째 점으로 이동 (다음 next() 가 그 점)
+    void seek(std::uint64_t index);
+
+    // 현재 점을 out[0..dims) 에 [0,1) 로 쓰고 다음 점으로 넘어간다
+    void next(double *out);
+
+    // index 번째 점을 상태와 상관없이 바로 계산 (O(32), 여러 thread 에서 불러도 된다)
+    void point(std::uint64_t index, double *out) const;
+
+    // index [first, first + count) 의 점을 out 에 차원 순서로 이어서 쓴다 (out 크기 count * dims)
+    // 상태는 first + count 로 옮겨진다
+    void fill(std::uint64_t first, std::size_t count, double *out);
+
+private:
+    std::uint32_t scramble(unsigned d, std::uint32_t x) const;
+
+    unsigned dims_;
+    SobolScramble scramble_;
+    std::uint32_t v_[kMaxDims][kBits];    // direction number (최상위 bit 부터)
+    std::uint32_t seed_[kMaxDims];        // 차원별 scramble seed
+    std::uint32_t x_[kMaxDims];           // index_ 번째 점 (scramble 전)
+    std::uint64_t index_ = 0;
+};
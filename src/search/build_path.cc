@@ -1,18 +1,21 @@
 // /src/search/build_path.cc
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 
-#include "env/environment.h"   // start/goal 좌표 정의용 (0,1번 노드지만 타입 맞추려고)
+#include "env/env_file.h"
+#include "env/environment.h"
 #include "roadmap/graph.h"
 #include "search/search.h"
 
 using namespace std;
 
-// graph.txt 로부터 Graph 읽기
-static void loadGraphFromFile(const std::string &filename, Graph &g) {
+// graph.txt 로부터 Graph 읽기 (double 로 읽어서 T 로 저장)
+template <class T>
+static void loadGraphFromFile(const std::string &filename, GraphT<T> &g) {
     ifstream ifs(filename);
     if (!ifs) {
         throw runtime_error("Cannot open graph file: " + filename);
@@ -28,7 +31,7 @@ static void loadGraphFromFile(const std::string &filename, Graph &g) {
         int id;
         double x, y;
         ifs >> id >> x >> y;
-        Vec2 p(x, y);
+        Vec2T<T> p(static_cast<T>(x), static_cast<T>(y));
         g.nodes.push_back({id, p});
     }
 
@@ -39,13 +42,14 @@ static void loadGraphFromFile(const std::string &filename, Graph &g) {
         int u, v;
         double w;
         ifs >> u >> v >> w;
-        g.edges.push_back({u, v, w});
+        g.edges.push_back({u, v, static_cast<T>(w)});
     }
 }
 
 // path.txt 로 저장
+template <class T>
 static void savePathToFile(const std::string &filename,
-                           const Graph &g,
+                           const GraphT<T> &g,
                            const std::vector<int> &path_ids)
 {
     ofstream ofs(filename);
@@ -54,25 +58,17 @@ static void savePathToFile(const std::string &filename,
     }
     ofs << path_ids.size() << "\n";
     for (int id : path_ids) {
-        const Vec2 &p = g.nodes[id].p;
+        const Vec2T<T> &p = g.nodes[id].p;
         ofs << p.x << " " << p.y << "\n";
     }
 }
 
-int main(int argc, char **argv) {
-    if (argc < 5) {
-        cerr << "Usage: " << argv[0]
-             << " <env_file> <graph_file> <search_type> <out_path_file>\n";
-        cerr << " search_type: bfs | dfs | gbfs | astar | wastar\n";
-        return 1;
-    }
-
-    std::string env_file   = argv[1]; // 현재는 직접 쓰지는 않지만, 인터페이스 용으로 유지
-    std::string graph_file = argv[2];
-    std::string search_str = argv[3];
-    std::string out_file   = argv[4];
-
-    Graph g;
+// graph 를 T 정밀도로 읽고 탐색해서 path 를 저장
+template <class T>
+static int searchGraph(const Environment &env, const std::string &env_file,
+                       const std::string &graph_file, const std::string &search_str,
+                       const std::string &out_file) {
+    GraphT<T> g;
     try {
         loadGraphFromFile(graph_file, g);
     } catch (const std::exception &e) {
@@ -88,6 +84,15 @@ int main(int argc, char **argv) {
     int start_id = 0; // build_roadmap에서 항상 start=0, goal=1 로 생성했다고 가정
     int goal_id  = 1;
 
+    // graph.txt 는 6 자리로 저장되므로 그 정도 차이는 허용
+    auto near = [](const Vec2T<T> &a, const Vec2 &b) {
+        return std::fabs(a.x - b.x) <= 1e-4 * (1.0 + std::fabs(b.x)) &&
+               std::fabs(a.y - b.y) <= 1e-4 * (1.0 + std::fabs(b.y));
+    };
+    if (!near(g.nodes[start_id].p, env.start) || !near(g.nodes[goal_id].p, env.goal)) {
+        cerr << "[build_path] Warning: graph start/goal do not match " << env_file << "\n";
+    }
+
     SearchType type;
     try {
         type = parse_search_type(search_str);
@@ -122,3 +127,47 @@ int main(int argc, char **argv) {
 
     return 0;
 }
+
+int main(int argc, char **argv) {
+    if (argc < 5) {
+        cerr << "Usage: " << argv[0]
+             << " <env_file> <graph_file> <search_type> <out_path_file> [--precision=double|float]\n";
+        cerr << " env_file: text (env.txt) or binary (build_env --format=binary)\n";
+        cerr << " search_type: bfs | dfs | gbfs | astar | wastar\n";
+        cerr << " --precision=float stores node coordinates and edge weights as float (half the memory)\n";
+        return 1;
+    }
+
+    std::string env_file   = argv[1]; // start/goal 이 graph 의 0, 1번 노드와 맞는지 확인용
+    std::string graph_file = argv[2];
+    std::string search_str = argv[3];
+    std::string out_file   = argv[4];
+
+    std::string precision = "double";
+    for (int i = 5; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--precision=", 0) == 0) {
+            precision = arg.substr(12);
+        } else {
+            cerr << "[build_path] Unexpected argument: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (precision != "double" && precision != "float") {
+        cerr << "[build_path] Unknown precision: " << precision << "\n";
+        return 1;
+    }
+
+    Environment env;
+    unsigned int env_seed = 0;
+    try {
+        loadEnvironment(env_file, env, env_seed);
+    } catch (const std::exception &e) {
+        cerr << "[build_path] Error loading environment: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (precision == "float")
+        return searchGraph<float>(env, env_file, graph_file, search_str, out_file);
+    return searchGraph<double>(env, env_file, graph_file, search_str, out_file);
+}
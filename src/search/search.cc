@@ -27,9 +27,10 @@ SearchType parse_search_type(const std::string &name) {
 }
 
 // 간단한 adjacency list 구성
+template <class T>
 static void build_adjacency(
-    const Graph &g,
-    vector<vector<std::pair<int, double>>> &adj)
+    const GraphT<T> &g,
+    vector<vector<std::pair<int, T>>> &adj)
 {
     const int n = static_cast<int>(g.nodes.size());
     adj.assign(n, {});
@@ -80,13 +81,14 @@ static bool reconstruct_path(
 
 // ===== Uninformed: BFS / DFS =====
 
+template <class T>
 static bool bfs_search(
-    const Graph &g,
+    const GraphT<T> &g,
     int start_id,
     int goal_id,
     vector<int> &path_ids)
 {
-    vector<vector<std::pair<int, double>>> adj;
+    vector<vector<std::pair<int, T>>> adj;
     build_adjacency(g, adj);
     const int n = static_cast<int>(adj.size());
     if (start_id < 0 || start_id >= n || goal_id < 0 || goal_id >= n)
@@ -117,13 +119,14 @@ static bool bfs_search(
     return reconstruct_path(start_id, goal_id, parent, path_ids);
 }
 
+template <class T>
 static bool dfs_search(
-    const Graph &g,
+    const GraphT<T> &g,
     int start_id,
     int goal_id,
     vector<int> &path_ids)
 {
-    vector<vector<std::pair<int, double>>> adj;
+    vector<vector<std::pair<int, T>>> adj;
     build_adjacency(g, adj);
     const int n = static_cast<int>(adj.size());
     if (start_id < 0 || start_id >= n || goal_id < 0 || goal_id >= n)
@@ -156,50 +159,54 @@ static bool dfs_search(
 
 // ===== Informed: GBFS / A* / Weighted A* =====
 
+template <class T>
 struct PQNode {
     int id;
-    double g;
-    double f;
+    T g;
+    T f;
 };
 
+template <class T>
 struct PQCompare {
-    bool operator()(const PQNode &a, const PQNode &b) const {
+    bool operator()(const PQNode<T> &a, const PQNode<T> &b) const {
         return a.f > b.f; // 작은 f가 먼저 나오도록
     }
 };
 
-static double heuristic_dist(const Graph &g, int v, int goal_id) {
-    const Vec2 &p = g.nodes[v].p;
-    const Vec2 &gpos = g.nodes[goal_id].p;
-    double dx = p.x - gpos.x;
-    double dy = p.y - gpos.y;
+template <class T>
+static T heuristic_dist(const GraphT<T> &g, int v, int goal_id) {
+    const Vec2T<T> &p = g.nodes[v].p;
+    const Vec2T<T> &gpos = g.nodes[goal_id].p;
+    T dx = p.x - gpos.x;
+    T dy = p.y - gpos.y;
     return std::sqrt(dx * dx + dy * dy);
 }
 
+template <class T>
 static bool best_first_search(
-    const Graph &g,
+    const GraphT<T> &g,
     int start_id,
     int goal_id,
     SearchType type,
     vector<int> &path_ids,
     double weight)
 {
-    vector<vector<std::pair<int, double>>> adj;
+    vector<vector<std::pair<int, T>>> adj;
     build_adjacency(g, adj);
     const int n = static_cast<int>(adj.size());
     if (start_id < 0 || start_id >= n || goal_id < 0 || goal_id >= n)
         return false;
 
-    const double INF = std::numeric_limits<double>::infinity();
-    vector<double> gval(n, INF);
+    const T INF = std::numeric_limits<T>::infinity();
+    vector<T> gval(n, INF);
     vector<int> parent(n, -1);
     vector<bool> closed(n, false);
 
-    std::priority_queue<PQNode, vector<PQNode>, PQCompare> open;
+    std::priority_queue<PQNode<T>, vector<PQNode<T>>, PQCompare<T>> open;
 
-    gval[start_id] = 0.0;
-    double h0 = heuristic_dist(g, start_id, goal_id);
-    double f0;
+    gval[start_id] = T(0);
+    T h0 = heuristic_dist(g, start_id, goal_id);
+    T f0;
     switch (type) {
         case SearchType::GBFS:
             f0 = h0;
@@ -208,16 +215,16 @@ static bool best_first_search(
             f0 = gval[start_id] + h0;
             break;
         case SearchType::WASTAR:
-            f0 = gval[start_id] + weight * h0;
+            f0 = gval[start_id] + static_cast<T>(weight) * h0;
             break;
         default:
             f0 = h0;
             break;
     }
-    open.push({start_id, 0.0, f0});
+    open.push({start_id, T(0), f0});
 
     while (!open.empty()) {
-        PQNode cur = open.top();
+        PQNode<T> cur = open.top();
         open.pop();
 
         int u = cur.id;
@@ -230,15 +237,15 @@ static bool best_first_search(
 
         for (auto &pr : adj[u]) {
             int v = pr.first;
-            double w = pr.second;
+            T w = pr.second;
             if (closed[v])
                 continue;
 
-            double g_new;
+            T g_new;
             if (type == SearchType::GBFS) {
                 // GBFS는 g를 중요하게 쓰지 않지만
                 // parent 관리를 위해 한 번만 방문
-                g_new = 0.0;
+                g_new = T(0);
                 if (parent[v] != -1)
                     continue;
             } else {
@@ -250,14 +257,14 @@ static bool best_first_search(
             parent[v] = u;
             gval[v] = g_new;
 
-            double h = heuristic_dist(g, v, goal_id);
-            double f;
+            T h = heuristic_dist(g, v, goal_id);
+            T f;
             if (type == SearchType::GBFS)
                 f = h;
             else if (type == SearchType::ASTAR)
                 f = g_new + h;
             else
-                f = g_new + weight * h; // WASTAR
+                f = g_new + static_cast<T>(weight) * h; // WASTAR
 
             open.push({v, g_new, f});
         }
@@ -266,8 +273,9 @@ static bool best_first_search(
     return reconstruct_path(start_id, goal_id, parent, path_ids);
 }
 
+template <class T>
 bool run_search(
-    const Graph &g,
+    const GraphT<T> &g,
     int start_id,
     int goal_id,
     SearchType type,
@@ -291,3 +299,6 @@ bool run_search(
         return false;
     }
 }
+
+template bool run_search<float>(const GraphF &, int, int, SearchType, vector<int> &, double);
+template bool run_search<double>(const Graph &, int, int, SearchType, vector<int> &, double);
@@ -20,10 +20,17 @@ SearchType parse_search_type(const std::string &name);
 // Run search on a given graph from start_id to goal_id
 // Returns true if path found, and fills path_ids with node ids (start..goal).
 // For non-weighted algorithms, weight is ignored. For WASTAR, weight > 1.0.
+// T = float / double (search.cc 에서 instantiate). 경로 비용도 T 로 누적한다
+template <class T>
 bool run_search(
-    const Graph &g,
+    const GraphT<T> &g,
     int start_id,
     int goal_id,
     SearchType type,
     std::vector<int> &path_ids,
     double weight = 2.0);
+
+extern template bool run_search<float>(const GraphF &, int, int, SearchType,
+                                       std::vector<int> &, double);
+extern template bool run_search<double>(const Graph &, int, int, SearchType,
+                                        std::vector<int> &, double);